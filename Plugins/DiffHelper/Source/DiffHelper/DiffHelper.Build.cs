@@ -49,6 +49,8 @@ public class DiffHelper : ModuleRules
 				"LiveCoding",
 				"AppFramework", 
 				"WorkspaceMenuStructure",
+				"AssetRegistry",
+				"Json",
 				// ... add private dependencies that you statically link with here ...	
 			}
 			);
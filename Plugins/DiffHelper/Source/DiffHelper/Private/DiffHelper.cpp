@@ -5,6 +5,7 @@
 #include "DiffHelperStyle.h"
 #include "DiffHelperCommands.h"
 #include "DiffHelperGitManager.h"
+#include "DiffHelperManager.h"
 #include "DiffHelperSettings.h"
 #include "DiffHelperTypes.h"
 #include "DiffHelperUtils.h"
@@ -111,6 +112,11 @@ void FDiffHelperModule::RegisterCommands()
 		FDiffHelperCommands::Get().OpenDiffWindow,
 		FExecuteAction::CreateRaw(this, &FDiffHelperModule::ToolbarButtonClicked),
 		FCanExecuteAction());
+
+	PluginCommands->MapAction(
+		FDiffHelperCommands::Get().RefreshCommitGraph,
+		FExecuteAction::CreateRaw(this, &FDiffHelperModule::RefreshCommitGraphClicked),
+		FCanExecuteAction::CreateRaw(this, &FDiffHelperModule::CanRefreshCommitGraph));
 }
 
 void FDiffHelperModule::RegisterTabSpawner()
@@ -143,6 +149,8 @@ void FDiffHelperModule::RegisterMenus()
 			{
 				auto& Entry = Section->AddMenuEntryWithCommandList(FDiffHelperCommands::Get().OpenDiffWindow, PluginCommands);
 				Entry.Icon = FSlateIcon(FDiffHelperStyle::GetStyleSetName(), "DiffHelper.Diff");
+
+				Section->AddMenuEntryWithCommandList(FDiffHelperCommands::Get().RefreshCommitGraph, PluginCommands);
 			}
 		}
 		
@@ -196,6 +204,31 @@ void FDiffHelperModule::ToolbarButtonClicked()
 		return;
 	}
 
+	InitializeManager();
+	FGlobalTabmanager::Get()->TryInvokeTab(DiffHelperConstants::DiffHelperRevisionPickerId);
+}
+
+void FDiffHelperModule::RefreshCommitGraphClicked()
+{
+	if (!ISourceControlModule::Get().IsEnabled())
+	{
+		UDiffHelperUtils::AddErrorNotification(LOCTEXT("RevisionControlDisabled", "Revision control is disabled."));
+		return;
+	}
+
+	if (InitializeManager())
+	{
+		DiffHelperManager->RefreshHistoryIndex();
+	}
+}
+
+bool FDiffHelperModule::CanRefreshCommitGraph() const
+{
+	return !DiffHelperManager.IsValid() || !DiffHelperManager->IsRefreshingHistoryIndex();
+}
+
+bool FDiffHelperModule::InitializeManager()
+{
 	// TODO: Check revision control was set up properly, if it changed, then manager should be changed as well
 	if (!DiffHelperManager.IsValid())
 	{
@@ -203,7 +236,7 @@ void FDiffHelperModule::ToolbarButtonClicked()
 		DiffHelperManager->Init();
 	}
 
-	FGlobalTabmanager::Get()->TryInvokeTab(DiffHelperConstants::DiffHelperRevisionPickerId);
+	return DiffHelperManager.IsValid();
 }
 
 #undef LOCTEXT_NAMESPACE
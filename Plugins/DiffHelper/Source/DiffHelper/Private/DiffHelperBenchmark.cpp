@@ -0,0 +1,310 @@
+﻿// Copyright 2024 Gradess Games. All Rights Reserved.
+
+
+#include "DiffHelperGitManager.h"
+#include "DiffHelperGitParser.h"
+#include "DiffHelperTypes.h"
+#include "DiffHelperUtils.h"
+#include "HAL/IConsoleManager.h"
+#include "Misc/AutomationTest.h"
+
+namespace DiffHelperBenchmark
+{
+	constexpr int32 DefaultCommitCount = 100000;
+	constexpr int32 FilesPerCommit = 3;
+	constexpr int32 DefaultPathCount = 100000;
+	constexpr int32 DefaultMergeFileCount = 5000;
+	constexpr int32 DefaultMergeCommitCount = 20;
+	constexpr int32 TestCommitCount = 10000;
+
+	void AppendBytes(TArray<uint8>& OutData, const FString& InText)
+	{
+		const FTCHARToUTF8 Converter(*InText, InText.Len());
+		OutData.Append(reinterpret_cast<const uint8*>(Converter.Get()), Converter.Length());
+	}
+
+	// Mirrors "git log --name-status" output for both the regex and the NUL-delimited formats
+	void GenerateLog(const int32 InCommitCount, FString& OutRegexLog, TArray<uint8>& OutRawLog)
+	{
+		static const FString Statuses[] = {TEXT("A"), TEXT("M"), TEXT("D"), TEXT("R100")};
+
+		for (int32 CommitIndex = 0; CommitIndex < InCommitCount; CommitIndex++)
+		{
+			const auto Hash = FString::Printf(TEXT("%07x"), CommitIndex);
+			const auto Message = FString::Printf(TEXT("Commit message number %d"), CommitIndex);
+			const auto Author = FString::Printf(TEXT("Author %d"), CommitIndex % 16);
+			const auto Date = FString::Printf(TEXT("%lld"), 1704067200ll + CommitIndex * 60ll);
+
+			if (CommitIndex > 0)
+			{
+				OutRegexLog += TEXT("\n\n");
+			}
+
+			OutRegexLog += FString::Printf(TEXT("<Hash:%s> <Message:%s> <Author:%s> <Date:%s>"), *Hash, *Message, *Author, *Date);
+
+			OutRawLog.Add(0x1E);
+			for (const auto& Field : {Hash, Message, Author, Date})
+			{
+				AppendBytes(OutRawLog, Field);
+				OutRawLog.Add(0);
+			}
+
+			OutRawLog.Add('\n');
+
+			for (int32 FileIndex = 0; FileIndex < DiffHelperBenchmark::FilesPerCommit; FileIndex++)
+			{
+				const auto& Status = Statuses[(CommitIndex + FileIndex) % UE_ARRAY_COUNT(Statuses)];
+				const auto Path = FString::Printf(TEXT("Content/Folder%d/Asset%d.uasset"), CommitIndex % 100, CommitIndex * FilesPerCommit + FileIndex);
+				const auto bRename = Status.StartsWith(TEXT("R"));
+
+				OutRegexLog += TEXT("\n") + Status + TEXT("\t");
+				AppendBytes(OutRawLog, Status);
+				OutRawLog.Add(0);
+
+				if (bRename)
+				{
+					OutRegexLog += TEXT("Content/Old/") + FPaths::GetCleanFilename(Path) + TEXT("\t");
+					AppendBytes(OutRawLog, TEXT("Content/Old/") + FPaths::GetCleanFilename(Path));
+					OutRawLog.Add(0);
+				}
+
+				OutRegexLog += Path;
+				AppendBytes(OutRawLog, Path);
+				OutRawLog.Add(0);
+			}
+
+			OutRawLog.Add(0);
+		}
+	}
+
+	int32 CountFiles(const TArray<FDiffHelperCommit>& InCommits)
+	{
+		int32 FileCount = 0;
+		for (const auto& Commit : InCommits)
+		{
+			FileCount += Commit.Files.Num();
+		}
+
+		return FileCount;
+	}
+
+	void RunLogParserBenchmark(const TArray<FString>& InArgs)
+	{
+		const int32 CommitCount = InArgs.Num() > 0 ? FCString::Atoi(*InArgs[0]) : DefaultCommitCount;
+		if (CommitCount <= 0)
+		{
+			UE_LOG(LogDiffHelper, Error, TEXT("Usage: DiffHelper.Benchmark.LogParser [CommitCount]"));
+			return;
+		}
+
+		FString RegexLog;
+		TArray<uint8> RawLog;
+		GenerateLog(CommitCount, RegexLog, RawLog);
+
+		UE_LOG(LogDiffHelper, Display, TEXT("Log parser benchmark: %d commits, regex log %d chars, raw log %d bytes"), CommitCount, RegexLog.Len(), RawLog.Num());
+
+		const double TokenizerStart = FPlatformTime::Seconds();
+		const auto TokenizerCommits = FDiffHelperGitParser::ParseCommits(RawLog);
+		const double TokenizerTime = FPlatformTime::Seconds() - TokenizerStart;
+
+		const auto* Manager = GetDefault<UDiffHelperGitManager>();
+
+		const double RegexStart = FPlatformTime::Seconds();
+		const auto RegexCommits = Manager->ParseCommits(RegexLog);
+		const double RegexTime = FPlatformTime::Seconds() - RegexStart;
+
+		UE_LOG(LogDiffHelper, Display, TEXT("Tokenizer: %.3f s (%d commits, %d files)"), TokenizerTime, TokenizerCommits.Num(), CountFiles(TokenizerCommits));
+		UE_LOG(LogDiffHelper, Display, TEXT("Regex: %.3f s (%d commits, %d files)"), RegexTime, RegexCommits.Num(), CountFiles(RegexCommits));
+		UE_LOG(LogDiffHelper, Display, TEXT("Speedup: x%.1f"), TokenizerTime > 0.0 ? RegexTime / TokenizerTime : 0.0);
+
+		if (TokenizerCommits.Num() != RegexCommits.Num() || CountFiles(TokenizerCommits) != CountFiles(RegexCommits))
+		{
+			UE_LOG(LogDiffHelper, Warning, TEXT("Parsers returned different results!"));
+		}
+	}
+
+	int32 CountNodes(const TArray<TSharedPtr<FDiffHelperItemNode>>& InNodes)
+	{
+		int32 NodeCount = InNodes.Num();
+		for (const auto& Node : InNodes)
+		{
+			NodeCount += CountNodes(Node->Children);
+		}
+
+		return NodeCount;
+	}
+
+	void RunTreeBenchmark(const TArray<FString>& InArgs)
+	{
+		const int32 PathCount = InArgs.Num() > 0 ? FCString::Atoi(*InArgs[0]) : DefaultPathCount;
+		if (PathCount <= 0)
+		{
+			UE_LOG(LogDiffHelper, Error, TEXT("Usage: DiffHelper.Benchmark.Tree [PathCount]"));
+			return;
+		}
+
+		// Few wide directories with thousands of assets each, similar to a real Content folder
+		TArray<TSharedPtr<FDiffHelperDiffItem>> Items;
+		Items.Reserve(PathCount);
+		for (int32 Index = 0; Index < PathCount; Index++)
+		{
+			auto Item = MakeShared<FDiffHelperDiffItem>();
+			Item->Path = FString::Printf(TEXT("Content/Folder%d/SubFolder%d/Asset%d.uasset"), Index % 20, Index % 3, Index);
+			Items.Add(Item);
+		}
+
+		const double StartTime = FPlatformTime::Seconds();
+		const auto Tree = UDiffHelperUtils::GenerateTree(Items);
+		const double BuildTime = FPlatformTime::Seconds() - StartTime;
+
+		UE_LOG(LogDiffHelper, Display, TEXT("Tree benchmark: %d paths, %d nodes, built in %.3f s"), PathCount, CountNodes(Tree), BuildTime);
+	}
+
+	// Heap memory owned by the commit, the commit itself is counted by its owner
+	SIZE_T GetCommitAllocatedSize(const FDiffHelperCommit& InCommit)
+	{
+		SIZE_T Size = InCommit.Revision.GetAllocatedSize() + InCommit.Message.GetAllocatedSize() + InCommit.Author.GetAllocatedSize();
+		Size += InCommit.Files.GetAllocatedSize();
+		for (const auto& File : InCommit.Files)
+		{
+			Size += File.Path.GetAllocatedSize();
+		}
+
+		return Size;
+	}
+
+	// Every commit of a merge touches every file, which is the worst case for copying commits into diff items
+	void RunCommitMemoryReport(const TArray<FString>& InArgs)
+	{
+		const int32 FileCount = InArgs.Num() > 0 ? FCString::Atoi(*InArgs[0]) : DefaultMergeFileCount;
+		const int32 CommitCount = InArgs.Num() > 1 ? FCString::Atoi(*InArgs[1]) : DefaultMergeCommitCount;
+		if (FileCount <= 0 || CommitCount <= 0)
+		{
+			UE_LOG(LogDiffHelper, Error, TEXT("Usage: DiffHelper.Benchmark.CommitMemory [FileCount] [CommitCount]"));
+			return;
+		}
+
+		TArray<FDiffHelperFileData> Files;
+		Files.Reserve(FileCount);
+		for (int32 FileIndex = 0; FileIndex < FileCount; FileIndex++)
+		{
+			Files.Add({FString::Printf(TEXT("Content/Merge/Folder%d/Asset%d.uasset"), FileIndex % 50, FileIndex), EDiffHelperFileStatus::Modified});
+		}
+
+		// The last one plays the last target commit
+		TArray<TSharedPtr<FDiffHelperCommit>> Commits;
+		for (int32 CommitIndex = 0; CommitIndex <= CommitCount; CommitIndex++)
+		{
+			auto Commit = MakeShared<FDiffHelperCommit>();
+			Commit->Revision = FString::Printf(TEXT("%07x"), CommitIndex);
+			Commit->Message = FString::Printf(TEXT("Merge commit number %d"), CommitIndex);
+			Commit->Author = TEXT("Author");
+			Commit->Files = Files;
+			Commits.Add(Commit);
+		}
+
+		TArray<FDiffHelperDiffItem> Items;
+		Items.Reserve(FileCount);
+		for (const auto& File : Files)
+		{
+			auto& Item = Items.AddDefaulted_GetRef();
+			Item.Path = File.Path;
+			Item.LastTargetCommit = Commits.Last();
+			Item.Commits.Append(Commits.GetData(), CommitCount);
+		}
+
+		// Shared layout: item allocations plus every commit once
+		SIZE_T SharedSize = Items.GetAllocatedSize();
+		for (const auto& Item : Items)
+		{
+			SharedSize += Item.Path.GetAllocatedSize() + Item.Commits.GetAllocatedSize();
+		}
+
+		for (const auto& Commit : Commits)
+		{
+			SharedSize += sizeof(FDiffHelperCommit) + GetCommitAllocatedSize(*Commit);
+		}
+
+		// Copied layout, as it was before interning: each item owns its copies. Items are built and measured one at a time,
+		// all of them at once wouldn't fit in memory with the default sizes
+		// The copied item held the last target commit by value instead of a shared pointer
+		constexpr SIZE_T CopiedItemSize = sizeof(FDiffHelperDiffItem) - sizeof(TSharedPtr<FDiffHelperCommit>) + sizeof(FDiffHelperCommit);
+		SIZE_T CopiedSize = Items.Num() * CopiedItemSize;
+		for (const auto& Item : Items)
+		{
+			const FString Path = Item.Path;
+			const FDiffHelperCommit LastTargetCommit = *Item.LastTargetCommit;
+			TArray<FDiffHelperCommit> ItemCommits;
+			ItemCommits.Reserve(Item.Commits.Num());
+			for (const auto& Commit : Item.Commits)
+			{
+				ItemCommits.Add(*Commit);
+			}
+
+			CopiedSize += Path.GetAllocatedSize() + GetCommitAllocatedSize(LastTargetCommit) + ItemCommits.GetAllocatedSize();
+			for (const auto& Commit : ItemCommits)
+			{
+				CopiedSize += GetCommitAllocatedSize(Commit);
+			}
+		}
+
+		// GetAllocatedSize reports requested sizes, allocator overhead comes on top of both figures
+		constexpr double BytesInMegabyte = 1024.0 * 1024.0;
+		UE_LOG(LogDiffHelper, Display, TEXT("Commit memory report: %d files, %d commits touching all of them"), FileCount, CommitCount);
+		UE_LOG(LogDiffHelper, Display, TEXT("Commits copied into items: %.1f MB"), CopiedSize / BytesInMegabyte);
+		UE_LOG(LogDiffHelper, Display, TEXT("Shared commits: %.1f MB (x%.0f less)"), SharedSize / BytesInMegabyte, SharedSize > 0 ? static_cast<double>(CopiedSize) / SharedSize : 0.0);
+	}
+
+	FAutoConsoleCommand LogParserBenchmarkCommand(
+		TEXT("DiffHelper.Benchmark.LogParser"),
+		TEXT("Compares regex and tokenizer git log parsing on a synthetic log. Usage: DiffHelper.Benchmark.LogParser [CommitCount]"),
+		FConsoleCommandWithArgsDelegate::CreateStatic(&RunLogParserBenchmark));
+
+	FAutoConsoleCommand TreeBenchmarkCommand(
+		TEXT("DiffHelper.Benchmark.Tree"),
+		TEXT("Measures diff tree generation on synthetic paths. Usage: DiffHelper.Benchmark.Tree [PathCount]"),
+		FConsoleCommandWithArgsDelegate::CreateStatic(&RunTreeBenchmark));
+
+	FAutoConsoleCommand CommitMemoryReportCommand(
+		TEXT("DiffHelper.Benchmark.CommitMemory"),
+		TEXT("Measures allocations of shared commits and of commits copied into items on a synthetic merge. Usage: DiffHelper.Benchmark.CommitMemory [FileCount] [CommitCount]"),
+		FConsoleCommandWithArgsDelegate::CreateStatic(&RunCommitMemoryReport));
+}
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+// Same comparison as DiffHelper.Benchmark.LogParser, so the tokenizer is checked against the regex parser on every perf run
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FDiffHelperLogParserBenchmarkTest, "DiffHelper.Benchmark.LogParser", EAutomationTestFlags::EditorContext | EAutomationTestFlags::PerfFilter)
+
+bool FDiffHelperLogParserBenchmarkTest::RunTest(const FString& Parameters)
+{
+	FString RegexLog;
+	TArray<uint8> RawLog;
+	DiffHelperBenchmark::GenerateLog(DiffHelperBenchmark::TestCommitCount, RegexLog, RawLog);
+
+	const double TokenizerStart = FPlatformTime::Seconds();
+	const auto TokenizerCommits = FDiffHelperGitParser::ParseCommits(RawLog);
+	const double TokenizerTime = FPlatformTime::Seconds() - TokenizerStart;
+
+	const double RegexStart = FPlatformTime::Seconds();
+	const auto RegexCommits = GetDefault<UDiffHelperGitManager>()->ParseCommits(RegexLog);
+	const double RegexTime = FPlatformTime::Seconds() - RegexStart;
+
+	AddInfo(FString::Printf(TEXT("Tokenizer: %.3f s, regex: %.3f s, %d commits"), TokenizerTime, RegexTime, TokenizerCommits.Num()));
+
+	TestEqual(TEXT("Tokenizer commit count"), TokenizerCommits.Num(), DiffHelperBenchmark::TestCommitCount);
+	TestEqual(TEXT("Tokenizer file count"), DiffHelperBenchmark::CountFiles(TokenizerCommits), DiffHelperBenchmark::TestCommitCount * DiffHelperBenchmark::FilesPerCommit);
+	TestEqual(TEXT("Regex commit count"), RegexCommits.Num(), TokenizerCommits.Num());
+	TestEqual(TEXT("Regex file count"), DiffHelperBenchmark::CountFiles(RegexCommits), DiffHelperBenchmark::CountFiles(TokenizerCommits));
+
+	if (TokenizerCommits.Num() > 0 && RegexCommits.Num() > 0)
+	{
+		TestEqual(TEXT("Revision"), TokenizerCommits[0].Revision, RegexCommits[0].Revision);
+		TestEqual(TEXT("Message"), TokenizerCommits[0].Message, RegexCommits[0].Message);
+		TestEqual(TEXT("Author"), TokenizerCommits[0].Author, RegexCommits[0].Author);
+	}
+
+	return true;
+}
+
+#endif
@@ -0,0 +1,190 @@
+﻿// Copyright 2024 Gradess Games. All Rights Reserved.
+
+
+#include "DiffHelperBlobCache.h"
+#include "DiffHelperTypes.h"
+#include "HAL/FileManager.h"
+
+FDiffHelperBlobCache::FDiffHelperBlobCache(const FString& InDirectory, const int64 InByteBudget)
+	: Directory(InDirectory)
+	, ByteBudget(InByteBudget)
+{
+	IFileManager::Get().MakeDirectory(*Directory, true);
+	Scan();
+}
+
+TOptional<FString> FDiffHelperBlobCache::Find(const FString& InBlobHash, const FString& InExtension)
+{
+	FScopeLock ScopeLock(&CriticalSection);
+
+	auto* Entry = Entries.Find(MakeKey(InBlobHash, InExtension));
+	if (!Entry)
+	{
+		return {};
+	}
+
+	// File could be removed by hand, the entry is useless then
+	if (!IFileManager::Get().FileExists(*Entry->Path))
+	{
+		UsedBytes -= Entry->Size;
+		Entries.Remove(MakeKey(InBlobHash, InExtension));
+		return {};
+	}
+
+	Entry->LastAccess = ++AccessCounter;
+
+	// Access order is restored from timestamps on the next start
+	IFileManager::Get().SetTimeStamp(*Entry->Path, FDateTime::UtcNow());
+	return Entry->Path;
+}
+
+FString FDiffHelperBlobCache::MakeTempPath() const
+{
+	return FPaths::CreateTempFilename(*Directory, TEXT("Temp"), TEXT(".tmp"));
+}
+
+TOptional<FString> FDiffHelperBlobCache::Add(const FString& InBlobHash, const FString& InExtension, const FString& InTempPath)
+{
+	SCOPED_NAMED_EVENT(FDiffHelperBlobCache_Add, FColor::Red);
+
+	FScopeLock ScopeLock(&CriticalSection);
+
+	const auto Key = MakeKey(InBlobHash, InExtension);
+	const auto Path = FPaths::ConvertRelativePathToFull(FPaths::Combine(Directory, Key));
+
+	// Another request could extract the same blob meanwhile
+	if (auto* Entry = Entries.Find(Key))
+	{
+		IFileManager::Get().Delete(*InTempPath, false, false, true);
+		Entry->LastAccess = ++AccessCounter;
+		return Entry->Path;
+	}
+
+	if (!IFileManager::Get().Move(*Path, *InTempPath, true, true))
+	{
+		UE_LOG(LogDiffHelper, Warning, TEXT("Failed to move %s into blob cache"), *InTempPath);
+		IFileManager::Get().Delete(*InTempPath, false, false, true);
+		return {};
+	}
+
+	auto& Entry = Entries.Add(Key);
+	Entry.Path = Path;
+	Entry.Size = IFileManager::Get().FileSize(*Path);
+	Entry.LastAccess = ++AccessCounter;
+	UsedBytes += Entry.Size;
+
+	Evict(Key);
+	return Path;
+}
+
+void FDiffHelperBlobCache::SetByteBudget(const int64 InByteBudget)
+{
+	FScopeLock ScopeLock(&CriticalSection);
+
+	if (ByteBudget != InByteBudget)
+	{
+		ByteBudget = InByteBudget;
+		Evict(FString());
+	}
+}
+
+int64 FDiffHelperBlobCache::GetUsedBytes() const
+{
+	FScopeLock ScopeLock(&CriticalSection);
+	return UsedBytes;
+}
+
+FString FDiffHelperBlobCache::MakeKey(const FString& InBlobHash, const FString& InExtension) const
+{
+	return InBlobHash + InExtension;
+}
+
+void FDiffHelperBlobCache::Scan()
+{
+	SCOPED_NAMED_EVENT(FDiffHelperBlobCache_Scan, FColor::Red);
+
+	struct FScannedFile
+	{
+		FString Path;
+		int64 Size;
+		FDateTime ModificationTime;
+	};
+
+	TArray<FScannedFile> Files;
+	IFileManager::Get().IterateDirectoryStat(*Directory, [&Files](const TCHAR* InPath, const FFileStatData& InStatData)
+	{
+		if (InStatData.bIsDirectory)
+		{
+			return true;
+		}
+
+		// Leftovers of interrupted extractions
+		if (FPaths::GetExtension(InPath) == TEXT("tmp"))
+		{
+			IFileManager::Get().Delete(InPath, false, false, true);
+			return true;
+		}
+
+		Files.Add({FPaths::ConvertRelativePathToFull(InPath), InStatData.FileSize, InStatData.ModificationTime});
+		return true;
+	});
+
+	Files.Sort([](const FScannedFile& A, const FScannedFile& B) { return A.ModificationTime < B.ModificationTime; });
+
+	for (const auto& File : Files)
+	{
+		auto& Entry = Entries.Add(FPaths::GetCleanFilename(File.Path));
+		Entry.Path = File.Path;
+		Entry.Size = File.Size;
+		Entry.LastAccess = ++AccessCounter;
+		UsedBytes += File.Size;
+	}
+
+	Evict(FString());
+}
+
+void FDiffHelperBlobCache::Evict(const FString& InKeepKey)
+{
+	if (UsedBytes <= ByteBudget)
+	{
+		return;
+	}
+
+	TArray<TPair<uint64, FString>> AccessOrder;
+	AccessOrder.Reserve(Entries.Num());
+	for (const auto& Pair : Entries)
+	{
+		AccessOrder.Emplace(Pair.Value.LastAccess, Pair.Key);
+	}
+
+	AccessOrder.Sort([](const TPair<uint64, FString>& A, const TPair<uint64, FString>& B) { return A.Key < B.Key; });
+
+	int32 EvictedCount = 0;
+	for (const auto& Pair : AccessOrder)
+	{
+		if (UsedBytes <= ByteBudget)
+		{
+			break;
+		}
+
+		// Just added blob is kept even if it's bigger than the budget on its own, it's about to be diffed
+		if (Pair.Value == InKeepKey)
+		{
+			continue;
+		}
+
+		const auto& Entry = Entries[Pair.Value];
+
+		// Files of open diffs can be locked, they are removed once they are released
+		if (!IFileManager::Get().Delete(*Entry.Path, false, false, true))
+		{
+			continue;
+		}
+
+		UsedBytes -= Entry.Size;
+		Entries.Remove(Pair.Value);
+		EvictedCount++;
+	}
+
+	UE_LOG(LogDiffHelper, Log, TEXT("Blob cache evicted %d files, %lld of %lld bytes used"), EvictedCount, UsedBytes, ByteBudget);
+}
@@ -2,6 +2,20 @@
 
 
 #include "DiffHelperCacheManager.h"
+#include "DiffHelperSettings.h"
+#include "DiffHelperUtils.h"
+#include "HAL/FileManager.h"
+#include "Misc/FileHelper.h"
+#include "Misc/SecureHash.h"
+#include "Serialization/MemoryReader.h"
+#include "Serialization/MemoryWriter.h"
+
+namespace DiffHelperDiffCache
+{
+	constexpr uint32 Magic = 0x44484443;
+	constexpr int32 Version = 3;
+	const FString Extension = TEXT(".diffcache");
+}
 
 const FString UDiffHelperCacheManager::ConfigSection = TEXT("DiffHelperCache");
 const FString UDiffHelperCacheManager::ConfigSourceBranchKey = TEXT("SourceBranch");
@@ -38,3 +52,219 @@ FString UDiffHelperCacheManager::GetConfigPath() const
 {
 	return FConfigCacheIni::NormalizeConfigIniPath(FPaths::Combine(FPaths::ProjectSavedDir(), TEXT("DiffHelperCache.ini")));
 }
+
+bool UDiffHelperCacheManager::LoadDiff(const FString& InSourceHash, const FString& InTargetHash, TArray<FDiffHelperDiffItem>& OutDiff)
+{
+	SCOPED_NAMED_EVENT(UDiffHelperCacheManager_LoadDiff, FColor::Red);
+
+	const auto CachePath = GetDiffCachePath(InSourceHash, InTargetHash);
+
+	TArray<uint8> Data;
+	if (!FFileHelper::LoadFileToArray(Data, *CachePath, FILEREAD_Silent))
+	{
+		return false;
+	}
+
+	FMemoryReader Reader(Data);
+
+	uint32 Magic = 0;
+	int32 Version = 0;
+	FString SourceHash;
+	FString TargetHash;
+	Reader << Magic << Version << SourceHash << TargetHash;
+
+	// File name is a hash of the key, so the key itself is checked as well
+	if (Reader.IsError() || Magic != DiffHelperDiffCache::Magic || Version != DiffHelperDiffCache::Version || SourceHash != InSourceHash || TargetHash != InTargetHash)
+	{
+		UE_LOG(LogDiffHelper, Warning, TEXT("Ignoring outdated diff cache %s"), *CachePath);
+		return false;
+	}
+
+	// Commits are stored once, items reference them by index
+	TArray<FDiffHelperCommit> LoadedCommits;
+	Reader << LoadedCommits;
+	const auto Commits = UDiffHelperUtils::ConvertToShared(MoveTemp(LoadedCommits));
+
+	int32 ItemCount = 0;
+	Reader << ItemCount;
+	if (Reader.IsError() || ItemCount < 0 || ItemCount > Data.Num())
+	{
+		return false;
+	}
+
+	auto GetCommit = [&Commits, &Reader](const int32 InIndex) -> TSharedPtr<FDiffHelperCommit>
+	{
+		if (InIndex == INDEX_NONE)
+		{
+			return nullptr;
+		}
+
+		if (!Commits.IsValidIndex(InIndex))
+		{
+			Reader.SetError();
+			return nullptr;
+		}
+
+		return Commits[InIndex];
+	};
+
+	OutDiff.Reset(ItemCount);
+	for (int32 ItemIndex = 0; ItemIndex < ItemCount && !Reader.IsError(); ItemIndex++)
+	{
+		auto& Item = OutDiff.AddDefaulted_GetRef();
+
+		int32 LastTargetCommitIndex = INDEX_NONE;
+		TArray<int32> CommitIndices;
+		Reader << Item.Path;
+		Reader << reinterpret_cast<uint8&>(Item.Status);
+		Reader << LastTargetCommitIndex;
+		Reader << CommitIndices;
+
+		Item.LastTargetCommit = GetCommit(LastTargetCommitIndex);
+
+		Item.Commits.Reserve(CommitIndices.Num());
+		for (const auto CommitIndex : CommitIndices)
+		{
+			Item.Commits.Add(GetCommit(CommitIndex));
+		}
+	}
+
+	if (Reader.IsError())
+	{
+		UE_LOG(LogDiffHelper, Warning, TEXT("Diff cache %s is corrupted"), *CachePath);
+		OutDiff.Reset();
+		return false;
+	}
+
+	// Timestamp is used to find the least recently used entries
+	IFileManager::Get().SetTimeStamp(*CachePath, FDateTime::UtcNow());
+	return true;
+}
+
+void UDiffHelperCacheManager::SaveDiff(const FString& InSourceHash, const FString& InTargetHash, const TArray<FDiffHelperDiffItem>& InDiff)
+{
+	SCOPED_NAMED_EVENT(UDiffHelperCacheManager_SaveDiff, FColor::Red);
+
+	TArray<TSharedPtr<FDiffHelperCommit>> Commits;
+	TMap<FString, int32> CommitIndices;
+
+	auto AddCommit = [&Commits, &CommitIndices](const TSharedPtr<FDiffHelperCommit>& InCommit) -> int32
+	{
+		if (!InCommit.IsValid() || !InCommit->IsValid())
+		{
+			return INDEX_NONE;
+		}
+
+		if (const auto* ExistingIndex = CommitIndices.Find(InCommit->Revision))
+		{
+			return *ExistingIndex;
+		}
+
+		const int32 Index = Commits.Add(InCommit);
+		CommitIndices.Add(InCommit->Revision, Index);
+		return Index;
+	};
+
+	TArray<int32> LastTargetCommitIndices;
+	TArray<TArray<int32>> ItemCommitIndices;
+	LastTargetCommitIndices.Reserve(InDiff.Num());
+	ItemCommitIndices.Reserve(InDiff.Num());
+
+	for (const auto& Item : InDiff)
+	{
+		LastTargetCommitIndices.Add(AddCommit(Item.LastTargetCommit));
+
+		auto& Indices = ItemCommitIndices.AddDefaulted_GetRef();
+		Indices.Reserve(Item.Commits.Num());
+		for (const auto& Commit : Item.Commits)
+		{
+			Indices.Add(AddCommit(Commit));
+		}
+	}
+
+	TArray<uint8> Data;
+	FMemoryWriter Writer(Data);
+
+	uint32 Magic = DiffHelperDiffCache::Magic;
+	int32 Version = DiffHelperDiffCache::Version;
+	FString SourceHash = InSourceHash;
+	FString TargetHash = InTargetHash;
+	Writer << Magic << Version << SourceHash << TargetHash;
+
+	// Same layout as TArray<FDiffHelperCommit>
+	int32 CommitCount = Commits.Num();
+	Writer << CommitCount;
+	for (const auto& Commit : Commits)
+	{
+		Writer << *Commit;
+	}
+
+	int32 ItemCount = InDiff.Num();
+	Writer << ItemCount;
+	for (int32 ItemIndex = 0; ItemIndex < ItemCount; ItemIndex++)
+	{
+		FString Path = InDiff[ItemIndex].Path;
+		uint8 Status = static_cast<uint8>(InDiff[ItemIndex].Status);
+		Writer << Path << Status << LastTargetCommitIndices[ItemIndex] << ItemCommitIndices[ItemIndex];
+	}
+
+	// Written under a unique name and moved, so concurrent diffs of the same revisions don't corrupt the entry
+	const auto CachePath = GetDiffCachePath(InSourceHash, InTargetHash);
+	const auto TempPath = FPaths::CreateTempFilename(*GetDiffCacheDirectory(), TEXT("Temp"), TEXT(".tmp"));
+	if (!FFileHelper::SaveArrayToFile(Data, *TempPath) || !IFileManager::Get().Move(*CachePath, *TempPath, true, true))
+	{
+		UE_LOG(LogDiffHelper, Warning, TEXT("Failed to write diff cache %s"), *CachePath);
+		IFileManager::Get().Delete(*TempPath, false, false, true);
+		return;
+	}
+
+	PruneDiffCache();
+}
+
+FString UDiffHelperCacheManager::GetDiffCacheDirectory()
+{
+	return FPaths::Combine(FPaths::ProjectSavedDir(), TEXT("DiffHelper"), TEXT("DiffCache"));
+}
+
+FString UDiffHelperCacheManager::GetDiffCachePath(const FString& InSourceHash, const FString& InTargetHash)
+{
+	const auto Key = InTargetHash + TEXT("..") + InSourceHash;
+	const FTCHARToUTF8 KeyUtf8(*Key, Key.Len());
+
+	FSHAHash Hash;
+	FSHA1::HashBuffer(KeyUtf8.Get(), KeyUtf8.Length(), Hash.Hash);
+
+	return FPaths::Combine(GetDiffCacheDirectory(), Hash.ToString() + DiffHelperDiffCache::Extension);
+}
+
+void UDiffHelperCacheManager::PruneDiffCache()
+{
+	struct FCacheEntry
+	{
+		FString Path;
+		FDateTime ModificationTime;
+	};
+
+	TArray<FCacheEntry> Entries;
+	IFileManager::Get().IterateDirectoryStat(*GetDiffCacheDirectory(), [&Entries](const TCHAR* InPath, const FFileStatData& InStatData)
+	{
+		if (!InStatData.bIsDirectory && FStringView(InPath).EndsWith(DiffHelperDiffCache::Extension))
+		{
+			Entries.Add({InPath, InStatData.ModificationTime});
+		}
+
+		return true;
+	});
+
+	const int32 MaxCachedDiffs = FMath::Max(GetDefault<UDiffHelperSettings>()->MaxCachedDiffs, 1);
+	if (Entries.Num() <= MaxCachedDiffs)
+	{
+		return;
+	}
+
+	Entries.Sort([](const FCacheEntry& A, const FCacheEntry& B) { return A.ModificationTime > B.ModificationTime; });
+	for (int32 Index = MaxCachedDiffs; Index < Entries.Num(); Index++)
+	{
+		IFileManager::Get().Delete(*Entries[Index].Path, false, false, true);
+	}
+}
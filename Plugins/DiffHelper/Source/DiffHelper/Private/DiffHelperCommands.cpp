@@ -8,6 +8,7 @@ void FDiffHelperCommands::RegisterCommands()
 {
 	UI_COMMAND(OpenDiffWindow, "Diff Helper", "Open diff helper window", EUserInterfaceActionType::Button, FInputChord());
 	UI_COMMAND(CreateNewDiff, "New...", "Create a new diff", EUserInterfaceActionType::Button, FInputChord());
+	UI_COMMAND(RefreshCommitGraph, "Refresh Git Commit-Graph", "Write a git commit-graph with changed-path Bloom filters in background, so Diff Helper history queries run faster", EUserInterfaceActionType::Button, FInputChord());
 
 	UI_COMMAND(GroupByDirectory, "Group By Directory", "Group diff items by directory", EUserInterfaceActionType::ToggleButton, FInputChord());
 	UI_COMMAND(ExpandAll, "Expand All", "Expand all diff items", EUserInterfaceActionType::Button, FInputChord());
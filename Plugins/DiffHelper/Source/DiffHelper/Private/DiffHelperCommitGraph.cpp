@@ -0,0 +1,53 @@
+﻿// Copyright 2024 Gradess Games. All Rights Reserved.
+
+
+#include "DiffHelperCommitGraph.h"
+
+FDiffHelperCommitGraph::FDiffHelperCommitGraph(TArray<FDiffHelperCommit>&& InCommits)
+{
+	SCOPED_NAMED_EVENT(FDiffHelperCommitGraph_Build, FColor::Red);
+
+	Commits.Reserve(InCommits.Num());
+	for (auto& Commit : InCommits)
+	{
+		const int32 CommitIndex = Commits.Add(MakeShared<FDiffHelperCommit>(MoveTemp(Commit)));
+		Commits[CommitIndex]->HistoryIndex = CommitIndex;
+
+		for (const auto& File : Commits[CommitIndex]->Files)
+		{
+			auto& Indices = PathIndex.FindOrAdd(File.Path);
+
+			// A path could be listed twice by a single commit, e.g. a type change shows up as delete and add
+			if (Indices.Num() == 0 || Indices.Last() != CommitIndex)
+			{
+				Indices.Add(CommitIndex);
+			}
+		}
+	}
+}
+
+void FDiffHelperCommitGraph::GetPaths(TArray<FString>& OutPaths) const
+{
+	PathIndex.GetKeys(OutPaths);
+}
+
+const TArray<int32>* FDiffHelperCommitGraph::FindCommitIndices(const FString& InPath) const
+{
+	return PathIndex.Find(InPath);
+}
+
+TArray<TSharedPtr<FDiffHelperCommit>> FDiffHelperCommitGraph::GetCommitsForPath(const FString& InPath) const
+{
+	TArray<TSharedPtr<FDiffHelperCommit>> PathCommits;
+
+	if (const auto* Indices = PathIndex.Find(InPath))
+	{
+		PathCommits.Reserve(Indices->Num());
+		for (const int32 Index : *Indices)
+		{
+			PathCommits.Add(Commits[Index]);
+		}
+	}
+
+	return PathCommits;
+}
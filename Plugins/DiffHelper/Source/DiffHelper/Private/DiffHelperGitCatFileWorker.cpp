@@ -0,0 +1,333 @@
+﻿// Copyright 2024 Gradess Games. All Rights Reserved.
+
+
+#include "DiffHelperGitCatFileWorker.h"
+#include "DiffHelperGitProcess.h"
+#include "DiffHelperTypes.h"
+
+namespace DiffHelperCatFileWorker
+{
+	constexpr int32 MaxRestartCount = 3;
+	constexpr double ReadTimeout = 60.0;
+	constexpr float WaitTimeout = 0.1f;
+}
+
+FDiffHelperGitCatFileWorker::FDiffHelperGitCatFileWorker(const FString& InGitBinaryPath, const FString& InRepositoryRoot, const EDiffHelperCatFileMode InMode)
+	: GitBinaryPath(InGitBinaryPath)
+	, RepositoryRoot(InRepositoryRoot)
+	, Mode(InMode)
+{
+}
+
+FDiffHelperGitCatFileWorker::~FDiffHelperGitCatFileWorker()
+{
+	Stop();
+}
+
+bool FDiffHelperGitCatFileWorker::Start()
+{
+	SCOPED_NAMED_EVENT(FDiffHelperGitCatFileWorker_Start, FColor::Red);
+
+	FScopeLock ScopeLock(&CriticalSection);
+
+	if (bDisabled)
+	{
+		return false;
+	}
+
+	if (Process.IsValid() && Process->IsRunning())
+	{
+		return true;
+	}
+
+	ResetBuffer();
+	Process = MakeUnique<FDiffHelperGitProcess>(GitBinaryPath, RepositoryRoot);
+
+	const auto Parameters = Mode == EDiffHelperCatFileMode::Batch ? TEXT("cat-file --batch --filters") : TEXT("cat-file --batch-check");
+	if (!Process->Launch(Parameters, true))
+	{
+		Process.Reset();
+		return false;
+	}
+
+	return true;
+}
+
+void FDiffHelperGitCatFileWorker::Stop()
+{
+	FScopeLock ScopeLock(&CriticalSection);
+
+	if (Process.IsValid())
+	{
+		// cat-file exits on its own once stdin is closed
+		Process->CloseInput();
+		Process.Reset();
+	}
+
+	ResetBuffer();
+}
+
+bool FDiffHelperGitCatFileWorker::IsAvailable() const
+{
+	return !bDisabled;
+}
+
+TOptional<FDiffHelperGitObjectInfo> FDiffHelperGitCatFileWorker::GetObjectInfo(const FString& InObjectName)
+{
+	SCOPED_NAMED_EVENT(FDiffHelperGitCatFileWorker_GetObjectInfo, FColor::Red);
+
+	if (!ensure(Mode == EDiffHelperCatFileMode::BatchCheck))
+	{
+		return {};
+	}
+
+	FScopeLock ScopeLock(&CriticalSection);
+
+	FDiffHelperGitObjectInfo Info;
+	if (!Request(InObjectName, Info, nullptr))
+	{
+		return {};
+	}
+
+	return Info;
+}
+
+bool FDiffHelperGitCatFileWorker::ReadObject(const FString& InObjectHash, const FString& InPath, FArchive& OutContent, FDiffHelperGitObjectInfo& OutInfo)
+{
+	SCOPED_NAMED_EVENT_F(TEXT("FDiffHelperGitCatFileWorker_ReadObject: %s"), FColor::Red, *InPath);
+
+	if (!ensure(Mode == EDiffHelperCatFileMode::Batch))
+	{
+		return false;
+	}
+
+	FScopeLock ScopeLock(&CriticalSection);
+
+	// With --filters git expects "<object> <path>", the path is used to pick smudge filters
+	const auto Line = FString::Printf(TEXT("%s %s"), *InObjectHash, *InPath);
+	return Request(Line, OutInfo, &OutContent);
+}
+
+bool FDiffHelperGitCatFileWorker::TryReadObject(const FString& InObjectHash, const FString& InPath, FArchive& OutContent, FDiffHelperGitObjectInfo& OutInfo)
+{
+	if (!CriticalSection.TryLock())
+	{
+		return false;
+	}
+
+	// ReadObject locks again, which is fine since FCriticalSection is recursive
+	const bool bResult = ReadObject(InObjectHash, InPath, OutContent, OutInfo);
+	CriticalSection.Unlock();
+
+	return bResult;
+}
+
+bool FDiffHelperGitCatFileWorker::Request(const FString& InLine, FDiffHelperGitObjectInfo& OutInfo, FArchive* OutContent)
+{
+	const int64 ContentStart = OutContent ? OutContent->Tell() : 0;
+
+	while (EnsureRunning())
+	{
+		// A retry writes the same contents again over whatever the failed attempt managed to write
+		if (OutContent)
+		{
+			OutContent->Seek(ContentStart);
+		}
+
+		const auto Result = ExecuteRequest(InLine, OutInfo, OutContent);
+		if (Result != ERequestResult::Failed)
+		{
+			// Only crashes in a row disable the worker, occasional ones over a long session don't
+			RestartCount = 0;
+			return Result == ERequestResult::Success;
+		}
+
+		UE_LOG(LogDiffHelper, Warning, TEXT("git cat-file worker failed on '%s', restarting"), *InLine);
+		if (!Restart())
+		{
+			break;
+		}
+	}
+
+	return false;
+}
+
+FDiffHelperGitCatFileWorker::ERequestResult FDiffHelperGitCatFileWorker::ExecuteRequest(const FString& InLine, FDiffHelperGitObjectInfo& OutInfo, FArchive* OutContent)
+{
+	if (!Process->Write(InLine + TEXT("\n")))
+	{
+		return ERequestResult::Failed;
+	}
+
+	FString Header;
+	if (!ReadLine(Header))
+	{
+		return ERequestResult::Failed;
+	}
+
+	// Expected header: "<hash> <type> <size>" or "<object> missing". Object names could contain spaces, so errors are matched by the end
+	if (Header.EndsWith(TEXT(" missing")) || Header.EndsWith(TEXT(" ambiguous")))
+	{
+		return ERequestResult::Missing;
+	}
+
+	TArray<FString> Tokens;
+	Header.ParseIntoArray(Tokens, TEXT(" "), true);
+
+	if (Tokens.Num() != 3 || !Tokens[2].IsNumeric())
+	{
+		return ERequestResult::Failed;
+	}
+
+	OutInfo.Hash = Tokens[0];
+	OutInfo.Type = Tokens[1];
+	OutInfo.Size = FCString::Atoi64(*Tokens[2]);
+
+	if (OutInfo.Size < 0)
+	{
+		return ERequestResult::Failed;
+	}
+
+	if (Mode == EDiffHelperCatFileMode::BatchCheck)
+	{
+		return ERequestResult::Success;
+	}
+
+	// Content is followed by a single LF
+	if (!ReadBytes(OutInfo.Size, OutContent) || !ReadBytes(1, nullptr))
+	{
+		return ERequestResult::Failed;
+	}
+
+	return ERequestResult::Success;
+}
+
+bool FDiffHelperGitCatFileWorker::EnsureRunning()
+{
+	if (bDisabled)
+	{
+		return false;
+	}
+
+	if (Process.IsValid() && Process->IsRunning())
+	{
+		return true;
+	}
+
+	return Restart();
+}
+
+bool FDiffHelperGitCatFileWorker::Restart()
+{
+	if (Process.IsValid())
+	{
+		Process->Terminate();
+		Process.Reset();
+	}
+
+	if (++RestartCount > DiffHelperCatFileWorker::MaxRestartCount)
+	{
+		UE_LOG(LogDiffHelper, Error, TEXT("git cat-file worker crashed too many times and has been disabled"));
+		bDisabled = true;
+		return false;
+	}
+
+	// Start takes the lock again, which is fine since FCriticalSection is recursive
+	return Start();
+}
+
+bool FDiffHelperGitCatFileWorker::ReadLine(FString& OutLine)
+{
+	while (true)
+	{
+		const int32 LineEnd = Buffer.Find('\n', BufferOffset);
+		if (LineEnd != INDEX_NONE)
+		{
+			const auto* LineStart = reinterpret_cast<const ANSICHAR*>(Buffer.GetData() + BufferOffset);
+			const FUTF8ToTCHAR Converter(LineStart, LineEnd - BufferOffset);
+			OutLine = FString(Converter.Length(), Converter.Get());
+
+			BufferOffset = LineEnd + 1;
+			return true;
+		}
+
+		if (!FillBuffer())
+		{
+			return false;
+		}
+	}
+}
+
+bool FDiffHelperGitCatFileWorker::ReadBytes(const int64 InCount, FArchive* OutData)
+{
+	int64 Remaining = InCount;
+	while (Remaining > 0)
+	{
+		const int32 Available = Buffer.Num() - BufferOffset;
+		if (Available == 0)
+		{
+			ResetBuffer();
+			if (!FillBuffer())
+			{
+				return false;
+			}
+
+			continue;
+		}
+
+		const int32 Count = static_cast<int32>(FMath::Min<int64>(Available, Remaining));
+		if (OutData)
+		{
+			OutData->Serialize(Buffer.GetData() + BufferOffset, Count);
+		}
+
+		BufferOffset += Count;
+		Remaining -= Count;
+	}
+
+	return true;
+}
+
+bool FDiffHelperGitCatFileWorker::FillBuffer()
+{
+	// Drop consumed data, so the buffer doesn't grow with each request
+	if (BufferOffset > 0)
+	{
+		Buffer.RemoveAt(0, BufferOffset, false);
+		BufferOffset = 0;
+	}
+
+	const double StartTime = FPlatformTime::Seconds();
+	while (FPlatformTime::Seconds() - StartTime < DiffHelperCatFileWorker::ReadTimeout)
+	{
+		if (Process->ReadOutput(Buffer) > 0)
+		{
+			return true;
+		}
+
+		if (!Process->IsRunning())
+		{
+			// Process could write the last chunk right before exit
+			return Process->ReadOutput(Buffer) > 0;
+		}
+
+		// Errors are drained as well, otherwise pending stderr data would wake every wait right away
+		FString Errors;
+		Process->ReadErrors(Errors);
+		if (!Errors.IsEmpty())
+		{
+			UE_LOG(LogDiffHelper, Warning, TEXT("git cat-file worker: %s"), *Errors.TrimEnd());
+		}
+
+		Process->WaitForOutput(DiffHelperCatFileWorker::WaitTimeout);
+	}
+
+	UE_LOG(LogDiffHelper, Error, TEXT("git cat-file worker timed out"));
+	return false;
+}
+
+void FDiffHelperGitCatFileWorker::ResetBuffer()
+{
+	Buffer.Reset();
+	BufferOffset = 0;
+}
@@ -2,14 +2,23 @@
 
 
 #include "DiffHelperGitManager.h"
+#include "DiffHelperBlobCache.h"
+#include "DiffHelperCacheManager.h"
+#include "DiffHelperCommitGraph.h"
+#include "DiffHelperGitCatFileWorker.h"
+#include "DiffHelperGitParser.h"
+#include "DiffHelperGitProcess.h"
 #include "DiffHelperSettings.h"
+#include "DiffHelperStats.h"
 #include "DiffHelperTypes.h"
 #include "DiffHelperUtils.h"
-#include "EditorAssetLibrary.h"
 #include "ISourceControlModule.h"
 #include "ISourceControlProvider.h"
 #include "SourceControlHelpers.h"
-#include "Algo/Accumulate.h"
+#include "Async/Async.h"
+#include "Framework/Notifications/NotificationManager.h"
+#include "Misc/ScopeExit.h"
+#include "Widgets/Notifications/SNotificationList.h"
 
 #if ENGINE_MAJOR_VERSION >= 5 && ENGINE_MINOR_VERSION <= 2
 #include "Internationalization/Regex.h"
@@ -22,6 +31,51 @@
 
 #define LOCTEXT_NAMESPACE "DiffHelperGitManager"
 
+namespace DiffHelperGitManager
+{
+	constexpr int32 DiffBatchSize = 500;
+
+	// Paths are split between parallel "git log" processes, each of them stops as soon as its paths are resolved
+	constexpr int32 MinLastCommitsBatchSize = 1000;
+	constexpr int32 MaxLastCommitsBatchCount = 8;
+
+	// Path that never exists, so the walk has to check every commit
+	const FString WalkProbePath = TEXT("DiffHelper/CommitGraphProbe");
+
+	// Commit-graph file starts with "CGPH", version, hash version, chunk count and base graph count, followed by a table of chunk ids and offsets
+	bool ReadCommitGraphChunks(const FString& InPath, bool& bOutHasChangedPaths)
+	{
+		const TUniquePtr<FArchive> Reader(IFileManager::Get().CreateFileReader(*InPath));
+		if (!Reader.IsValid() || Reader->TotalSize() < 8)
+		{
+			return false;
+		}
+
+		uint8 Header[8];
+		Reader->Serialize(Header, sizeof(Header));
+		if (FMemory::Memcmp(Header, "CGPH", 4) != 0)
+		{
+			return false;
+		}
+
+		bOutHasChangedPaths = false;
+		const int32 ChunkCount = Header[6];
+		for (int32 ChunkIndex = 0; ChunkIndex < ChunkCount && !Reader->AtEnd(); ChunkIndex++)
+		{
+			uint8 Entry[12];
+			Reader->Serialize(Entry, sizeof(Entry));
+
+			// Bloom filters are stored in "BIDX" and "BDAT" chunks
+			if (FMemory::Memcmp(Entry, "BIDX", 4) == 0)
+			{
+				bOutHasChangedPaths = true;
+			}
+		}
+
+		return !Reader->IsError();
+	}
+}
+
 bool UDiffHelperGitManager::Init()
 {
 	SCOPED_NAMED_EVENT(UDiffHelperGitManager_Init, FColor::Red);
@@ -29,11 +83,55 @@ bool UDiffHelperGitManager::Init()
 	AddToRoot();
 	LoadGitBinaryPath();
 
-	return !GitBinaryPath.IsEmpty();
+	bShuttingDown = false;
+	RepositoryRoot = FindRepositoryDirectory();
+
+	if (GitBinaryPath.IsEmpty())
+	{
+		return false;
+	}
+
+	StartWorkers();
+
+	// Managers of other repositories run next to the main one, and a cache deletes temp files of its directory on start
+	auto BlobCacheDirectory = FPaths::Combine(FPaths::DiffDir(), TEXT("DiffHelper"), TEXT("Blobs"));
+	if (!RepositoryRootOverride.IsEmpty())
+	{
+		const auto RepositoryHash = FString::Printf(TEXT("%08X"), FCrc::StrCrc32(*FPaths::ConvertRelativePathToFull(RepositoryRootOverride)));
+		BlobCacheDirectory = FPaths::Combine(FPaths::DiffDir(), TEXT("DiffHelper"), TEXT("RepositoryOverrides"), RepositoryHash, TEXT("Blobs"));
+	}
+
+	BlobCache = MakeShared<FDiffHelperBlobCache>(BlobCacheDirectory, GetDefault<UDiffHelperSettings>()->BlobCacheSizeMB * 1024ll * 1024ll);
+
+	ObjectsInfoDirectory = FindObjectsInfoDirectory().Get(FString());
+
+	const auto CommitGraphStatus = GetCommitGraphStatus();
+	if (!CommitGraphStatus.bHasChangedPaths)
+	{
+		if (GetDefault<UDiffHelperSettings>()->bWriteCommitGraph)
+		{
+			RefreshHistoryIndex();
+		}
+		else
+		{
+			UE_LOG(LogDiffHelper, Display, TEXT("Repository has no commit-graph with changed-path Bloom filters, history queries could be much faster after \"Tools > Refresh Git Commit-Graph\""));
+		}
+	}
+
+	return true;
 }
 
 void UDiffHelperGitManager::Deinit()
 {
+	// Background diffs and file extractions use this object, so they have to finish before it can be garbage collected
+	bShuttingDown = true;
+	while (ActiveDiffCount.GetValue() > 0)
+	{
+		FPlatformProcess::Sleep(0.01f);
+	}
+
+	StopWorkers();
+	BlobCache.Reset();
 	RemoveFromRoot();
 }
 
@@ -115,38 +213,107 @@ TArray<FDiffHelperBranch> UDiffHelperGitManager::GetBranches() const
 TArray<FDiffHelperDiffItem> UDiffHelperGitManager::GetDiff(const FString& InSourceRevision, const FString& InTargetRevision) const
 {
 	SCOPED_NAMED_EVENT(UDiffHelperGitManager_GetDiff, FColor::Red);
-	
-	const auto Commits = GetDiffCommitsList(InSourceRevision, InTargetRevision);
 
-	TMap<FString, TArray<FDiffHelperCommit>> ChangedFiles;
-	for (const auto& Commit : Commits)
+	TArray<FDiffHelperDiffItem> DiffItems;
+
+	FDiffHelperDiffContext Context;
+	Context.OnBatchReady = [&DiffItems](TArray<FDiffHelperDiffItem>&& InItems)
 	{
-		for (const auto& File : Commit.Files)
+		DiffItems.Append(MoveTemp(InItems));
+	};
+
+	StreamDiff(InSourceRevision, InTargetRevision, Context);
+
+	UDiffHelperUtils::ResolveAssetData(DiffItems);
+
+	return DiffItems;
+}
+
+void UDiffHelperGitManager::StreamDiff(const FString& InSourceRevision, const FString& InTargetRevision, const FDiffHelperDiffContext& InContext) const
+{
+	SCOPED_NAMED_EVENT(UDiffHelperGitManager_StreamDiff, FColor::Red);
+	DIFFHELPER_TRACE_SCOPE(DiffHelper_StreamDiff);
+
+	ActiveDiffCount.Increment();
+	ON_SCOPE_EXIT { ActiveDiffCount.Decrement(); };
+
+	auto IsCancelled = [this, &InContext]() { return bShuttingDown || InContext.IsCancelled(); };
+
+	const double StartTime = FPlatformTime::Seconds();
+
+	TOptional<FString> SourceHash;
+	TOptional<FString> TargetHash;
+	if (GetDefault<UDiffHelperSettings>()->bEnableDiffCache)
+	{
+		SourceHash = ResolveRevision(InSourceRevision);
+		TargetHash = ResolveRevision(InTargetRevision);
+	}
+
+	const bool bCacheable = SourceHash.IsSet() && TargetHash.IsSet();
+	if (bCacheable)
+	{
+		TArray<FDiffHelperDiffItem> CachedDiff;
+		const bool bCacheHit = UDiffHelperCacheManager::LoadDiff(SourceHash.GetValue(), TargetHash.GetValue(), CachedDiff);
+		FDiffHelperStats::Get().RecordDiffCache(bCacheHit);
+
+		if (bCacheHit)
 		{
-			if (!ChangedFiles.Contains(File.Path))
+			FDiffHelperDiffStats DiffStats;
+			DiffStats.Range = InTargetRevision + TEXT("..") + InSourceRevision;
+			DiffStats.bFromCache = true;
+			DiffStats.TotalSeconds = FPlatformTime::Seconds() - StartTime;
+			DiffStats.FileCount = CachedDiff.Num();
+			FDiffHelperStats::Get().RecordDiff(DiffStats);
+
+			UE_LOG(LogDiffHelper, Log, TEXT("Diff %s..%s loaded from cache in %.3fs (%d files)"), *InTargetRevision, *InSourceRevision, DiffStats.TotalSeconds, CachedDiff.Num());
+
+			for (int32 BatchStart = 0; BatchStart < CachedDiff.Num(); BatchStart += DiffHelperGitManager::DiffBatchSize)
 			{
-				ChangedFiles.Add(File.Path, TArray<FDiffHelperCommit>());
+				if (IsCancelled()) { return; }
+
+				const int32 BatchCount = FMath::Min(DiffHelperGitManager::DiffBatchSize, CachedDiff.Num() - BatchStart);
+				InContext.ReportBatch(TArray<FDiffHelperDiffItem>(CachedDiff.GetData() + BatchStart, BatchCount));
 			}
 
-			ChangedFiles[File.Path].Add(Commit);
+			return;
 		}
 	}
 
-	const auto& Statuses = GetStatuses(InSourceRevision, InTargetRevision);
+	// Resolved hashes are used for the queries, so the result matches the cache key even if a branch moves meanwhile
+	const auto SourceRevision = bCacheable ? SourceHash.GetValue() : InSourceRevision;
+	const auto TargetRevision = bCacheable ? TargetHash.GetValue() : InTargetRevision;
 
-	TArray<FString> Files;
-	ChangedFiles.GetKeys(Files);
-	const auto LastCommits = GetLastCommitForFiles(Files, InTargetRevision);
+	FDiffHelperDiffQueryResult QueryResult;
+	if (!QueryDiff(SourceRevision, TargetRevision, InContext, QueryResult) || IsCancelled()) { return; }
 
-	TArray<FDiffHelperDiffItem> DiffItems;
-	for (const auto& Pair : ChangedFiles)
+	auto& DiffStats = QueryResult.Stats;
+	DiffStats.Range = InTargetRevision + TEXT("..") + InSourceRevision;
+	DiffStats.FileCount = QueryResult.Files.Num();
+	DiffStats.CommitCount = QueryResult.CommitGraph.GetCommits().Num();
+
+	InContext.ReportStage(LOCTEXT("PopulatingFiles", "Populating files..."));
+	DIFFHELPER_TRACE_SCOPE(DiffHelper_PopulateFiles);
+
+	// Partial results aren't cached, otherwise a failed query would stick until one of the branches moves
+	const bool bSaveToCache = bCacheable && QueryResult.bSuccess;
+	TArray<FDiffHelperDiffItem> DiffToCache;
+	if (bSaveToCache)
+	{
+		DiffToCache.Reserve(QueryResult.Files.Num());
+	}
+
+	TArray<FDiffHelperDiffItem> Batch;
+	Batch.Reserve(DiffHelperGitManager::DiffBatchSize);
+
+	for (auto& File : QueryResult.Files)
 	{
-		FDiffHelperDiffItem DiffItem;
-		DiffItem.Path = Pair.Key;
+		FDiffHelperDiffItem& DiffItem = Batch.AddDefaulted_GetRef();
+		DiffItem.Commits = QueryResult.CommitGraph.GetCommitsForPath(File);
+		DiffItem.Path = MoveTemp(File);
 #if ENGINE_MAJOR_VERSION >= 5 && ENGINE_MINOR_VERSION >= 4
-		DiffItem.Status = Statuses.FindRef(DiffItem.Path, EDiffHelperFileStatus::None);
+		DiffItem.Status = QueryResult.Statuses.FindRef(DiffItem.Path, EDiffHelperFileStatus::None);
 #else
-		DiffItem.Status = Statuses.Contains(DiffItem.Path) ? Statuses.FindRef(DiffItem.Path) : EDiffHelperFileStatus::None;
+		DiffItem.Status = QueryResult.Statuses.Contains(DiffItem.Path) ? QueryResult.Statuses.FindRef(DiffItem.Path) : EDiffHelperFileStatus::None;
 #endif
 		
 
@@ -155,49 +322,170 @@ TArray<FDiffHelperDiffItem> UDiffHelperGitManager::GetDiff(const FString& InSour
 			UE_LOG(LogDiffHelper, Error, TEXT("Failed to get status for file: %s"), *DiffItem.Path);
 		}
 
-		const auto RelativePath = FPaths::Combine(FPaths::ProjectDir(), DiffItem.Path);
-		if (FPaths::IsUnderDirectory(RelativePath, FPaths::ProjectContentDir()))
+		DiffItem.LastTargetCommit = QueryResult.LastCommits.FindRef(DiffItem.Path);
+
+		if (Batch.Num() >= DiffHelperGitManager::DiffBatchSize)
 		{
-			FString PackageName;
-			if (FPackageName::TryConvertFilenameToLongPackageName(RelativePath, PackageName) && UDiffHelperUtils::IsUnrealAsset(RelativePath))
+			if (IsCancelled()) { return; }
+
+			if (bSaveToCache)
 			{
-				const auto AssetData = UEditorAssetLibrary::FindAssetData(PackageName);
-				if (AssetData.IsValid())
-				{
-					DiffItem.AssetData = AssetData;
-				}
+				DiffToCache.Append(Batch);
 			}
+
+			InContext.ReportBatch(MoveTemp(Batch));
+			Batch.Reset(DiffHelperGitManager::DiffBatchSize);
 		}
+	}
 
-		DiffItem.LastTargetCommit = LastCommits.FindRef(DiffItem.Path);
-		DiffItem.Commits = Pair.Value;
-		DiffItems.Add(DiffItem);
+	if (IsCancelled()) { return; }
+
+	if (bSaveToCache)
+	{
+		DiffToCache.Append(Batch);
 	}
 
-	return DiffItems;
+	if (Batch.Num() > 0)
+	{
+		InContext.ReportBatch(MoveTemp(Batch));
+	}
+
+	if (bSaveToCache)
+	{
+		UDiffHelperCacheManager::SaveDiff(SourceHash.GetValue(), TargetHash.GetValue(), DiffToCache);
+	}
+
+	DiffStats.TotalSeconds = FPlatformTime::Seconds() - StartTime;
+	FDiffHelperStats::Get().RecordDiff(DiffStats);
+}
+
+bool UDiffHelperGitManager::QueryDiff(const FString& InSourceRevision, const FString& InTargetRevision, const FDiffHelperDiffContext& InContext, FDiffHelperDiffQueryResult& OutResult) const
+{
+	SCOPED_NAMED_EVENT(UDiffHelperGitManager_QueryDiff, FColor::Red);
+
+	auto IsCancelled = [this, &InContext]() { return bShuttingDown || InContext.IsCancelled(); };
+
+	const double StartTime = FPlatformTime::Seconds();
+
+	InContext.ReportStage(LOCTEXT("CollectingCommits", "Collecting commits..."));
+
+	// Statuses don't depend on the log, so both processes run while the log is parsed.
+	// Cancelling the diff terminates the processes instead of waiting for them to finish
+	auto LogFuture = ExecuteCommandAsync(TEXT("log"), MakeCommitWalkParameters(InSourceRevision, InTargetRevision), InContext.CancellationFlag);
+	auto StatusFuture = ExecuteCommandAsync(TEXT("diff"), MakeStatusParameters(InSourceRevision, InTargetRevision), InContext.CancellationFlag);
+
+	const auto LogResult = LogFuture.Get();
+	if (IsCancelled()) { return false; }
+
+	if (!LogResult.bSuccess)
+	{
+		UE_LOG(LogDiffHelper, Error, TEXT("Failed to get diff commits: %s"), *LogResult.Errors);
+	}
+
+	double ParseStartTime = FPlatformTime::Seconds();
+	{
+		DIFFHELPER_TRACE_SCOPE(DiffHelper_ParseLog);
+
+		// Each commit is allocated once and shared by all files it touches
+		OutResult.CommitGraph = FDiffHelperCommitGraph(ParseLogOutput(LogResult.Output));
+		OutResult.CommitGraph.GetPaths(OutResult.Files);
+	}
+
+	const double LogParseTime = FPlatformTime::Seconds() - ParseStartTime;
+
+	InContext.ReportStage(LOCTEXT("CollectingLastCommits", "Looking for last target commits..."));
+
+	// Own thread, the caller is usually a pool task and blocking pool threads on pool tasks can starve the pool
+	auto LastCommitsFuture = Async(EAsyncExecution::Thread, [this, Files = OutResult.Files, InTargetRevision, CancellationFlag = InContext.CancellationFlag]()
+	{
+		return QueryLastCommits(Files, InTargetRevision, CancellationFlag);
+	});
+
+	// The task uses the manager, so it has to finish on every path before StreamDiff lets Deinit go on
+	ON_SCOPE_EXIT { LastCommitsFuture.Wait(); };
+
+	const auto StatusResult = StatusFuture.Get();
+	if (IsCancelled()) { return false; }
+
+	if (!StatusResult.bSuccess)
+	{
+		UE_LOG(LogDiffHelper, Error, TEXT("Failed to get statuses: %s"), *StatusResult.Errors);
+	}
+
+	ParseStartTime = FPlatformTime::Seconds();
+	{
+		DIFFHELPER_TRACE_SCOPE(DiffHelper_ParseStatus);
+		OutResult.Statuses = ParseStatusOutput(StatusResult.Output);
+	}
+
+	const double StatusParseTime = FPlatformTime::Seconds() - ParseStartTime;
+
+	auto LastCommitsResult = LastCommitsFuture.Get();
+	if (IsCancelled()) { return false; }
+
+	if (!LastCommitsResult.bSuccess)
+	{
+		UE_LOG(LogDiffHelper, Error, TEXT("Failed to get last commit for files: %s"), *LastCommitsResult.Errors);
+	}
+
+	OutResult.LastCommits = MoveTemp(LastCommitsResult.LastCommits);
+	OutResult.bSuccess = LogResult.bSuccess && StatusResult.bSuccess && LastCommitsResult.bSuccess;
+
+	auto& Stats = OutResult.Stats;
+	Stats.LogSeconds = LogResult.Duration;
+	Stats.LogParseSeconds = LogParseTime;
+	Stats.StatusSeconds = StatusResult.Duration;
+	Stats.StatusParseSeconds = StatusParseTime;
+	Stats.LastCommitsSeconds = LastCommitsResult.Duration;
+
+	// Commit-graph state is logged with the timings, so they can be compared before and after writing it
+	const auto CommitGraphStatus = GetCommitGraphStatus();
+	UE_LOG(LogDiffHelper, Log, TEXT("Diff %s..%s git queries: log %.3fs (parse %.3fs), diff %.3fs (parse %.3fs), last commits %.3fs (%d batches), wall time %.3fs, commit-graph: %s"),
+		*InTargetRevision, *InSourceRevision,
+		LogResult.Duration, LogParseTime,
+		StatusResult.Duration, StatusParseTime,
+		LastCommitsResult.Duration, LastCommitsResult.BatchCount,
+		FPlatformTime::Seconds() - StartTime,
+		CommitGraphStatus.bHasChangedPaths ? TEXT("with Bloom filters") : CommitGraphStatus.bExists ? TEXT("without Bloom filters") : TEXT("none"));
+
+	return true;
+}
+
+TOptional<FString> UDiffHelperGitManager::ResolveRevision(const FString& InRevision) const
+{
+	SCOPED_NAMED_EVENT(UDiffHelperGitManager_ResolveRevision, FColor::Red);
+
+	TArray<uint8> Output;
+	FString Errors;
+	if (!ExecuteCommandRaw(TEXT("rev-parse"), {TEXT("--verify"), TEXT("--quiet"), InRevision + TEXT("^{commit}")}, Output, Errors))
+	{
+		UE_LOG(LogDiffHelper, Warning, TEXT("Failed to resolve revision %s: %s"), *InRevision, *Errors);
+		return {};
+	}
+
+	const FUTF8ToTCHAR Converter(reinterpret_cast<const ANSICHAR*>(Output.GetData()), Output.Num());
+	const auto Hash = FString(Converter.Length(), Converter.Get()).TrimStartAndEnd();
+	if (Hash.IsEmpty())
+	{
+		return {};
+	}
+
+	return Hash;
 }
 
 TArray<FDiffHelperCommit> UDiffHelperGitManager::GetDiffCommitsList(const FString& InSourceBranch, const FString& InTargetBranch) const
 {
 	SCOPED_NAMED_EVENT(FDiffHelperGitManager_GetDiffCommitsList, FColor::Red);
 	
-	const FString Command = TEXT("log");
-	FString Result;
+	TArray<FDiffHelperCommit> Commits;
 	FString Errors;
 
-	TArray<FString> Params;
-	Params.Add(TEXT("--pretty=format:\"<Hash:%h> <Message:%s> <Author:%an> <Date:%ad>\""));
-	Params.Add(TEXT("--date=format-local:\"%d/%m/%Y %H:%M\""));
-	Params.Add(TEXT("--name-status"));
-	Params.Add(InTargetBranch + TEXT("..") + InSourceBranch);
-
-	if (!ExecuteCommand(Command, Params, {}, Result, Errors))
+	if (!ExecuteLog(MakeDiffCommitsParameters(InSourceBranch, InTargetBranch), Commits, Errors))
 	{
 		UE_LOG(LogDiffHelper, Error, TEXT("Failed to get diff commits: %s"), *Errors);
 		return {};
 	}
 
-	TArray<FDiffHelperCommit> Commits = ParseCommits(Result);
 	return Commits;
 }
 
@@ -205,26 +493,21 @@ FDiffHelperCommit UDiffHelperGitManager::GetLastCommitForFile(const FString& InF
 {
 	SCOPED_NAMED_EVENT(UDiffHelperGitManager_GetLastCommitForFile, FColor::Red);
 	
-	const FString Command = TEXT("log");
-	FString Result;
-	FString Errors;
-
 	TArray<FString> Params;
 	Params.Add(InBranch);
 	Params.Add(TEXT("-n 1"));
-	Params.Add(TEXT("--pretty=format:\"<Hash:%h> <Message:%s> <Author:%an> <Date:%ad>\""));
-	Params.Add(TEXT("--date=format-local:\"%d/%m/%Y %H:%M\""));
-	Params.Add(TEXT("--name-status"));
 	Params.Add(TEXT("-- ") + InFilePath);
 
-	if (!ExecuteCommand(Command, Params, {}, Result, Errors))
+	TArray<FDiffHelperCommit> Commits;
+	FString Errors;
+
+	if (!ExecuteLog(Params, Commits, Errors))
 	{
 		UE_LOG(LogDiffHelper, Error, TEXT("Failed to get last commit for file: %s. Error: %s"), *InFilePath, *Errors);
 		return {};
 	}
 
-	FDiffHelperCommit Commit = ParseCommit(Result);
-	return Commit;
+	return Commits.Num() > 0 ? Commits[0] : FDiffHelperCommit();
 }
 
 FSlateIcon UDiffHelperGitManager::GetStatusIcon(const EDiffHelperFileStatus InStatus) const
@@ -250,185 +533,812 @@ FSlateIcon UDiffHelperGitManager::GetStatusIcon(const EDiffHelperFileStatus InSt
 	}
 }
 
-TOptional<FString> UDiffHelperGitManager::GetFile(const FString& InFilename, const FString& InRevision) const
+bool UDiffHelperGitManager::BeginBackgroundTask() const
 {
-	SCOPED_NAMED_EVENT(UDiffHelperGitManager_GetFile, FColor::Red);
-	
-	IFileManager::Get().MakeDirectory(*FPaths::DiffDir(), true);
-	const FString TempFileName = FString::Printf(TEXT("%stemp-%s-%s"), *FPaths::DiffDir(), *InRevision, *FPaths::GetCleanFilename(InFilename));
-	TOptional<FString> FilePath = FPaths::ConvertRelativePathToFull(TempFileName);
-
-	// Diff against the revision
-	const FString Parameter = FString::Printf(TEXT("%s:%s"), *InRevision, *InFilename);
-
-	bool bCommandSuccessful;
-	if(FPaths::FileExists(FilePath.GetValue()))
-	{
-		// if the temp file already exists, reuse it directly
-		bCommandSuccessful = true;
-	}
-	else
+	// Deinit could set the flag right before the increment, it can't miss the task once the flag is checked after it
+	ActiveDiffCount.Increment();
+	if (bShuttingDown)
 	{
-		const auto RepositoryRoot = GetRepositoryDirectory();
-		// bCommandSuccessful = GitSourceControlUtils::RunDumpToFile(GitBinaryPath, RepositoryRoot, Parameter, FilePath);
-		bCommandSuccessful = ExtractFile(Parameter, FilePath.GetValue());
+		ActiveDiffCount.Decrement();
+		return false;
 	}
-	
-	return bCommandSuccessful ? FilePath : TOptional<FString>();
+
+	return true;
 }
 
-TMap<FString, FDiffHelperCommit> UDiffHelperGitManager::GetLastCommitForFiles(const TArray<FString>& InFilePaths, const FString& InBranch) const
+void UDiffHelperGitManager::EndBackgroundTask() const
 {
-	SCOPED_NAMED_EVENT(UDiffHelperGitManager_GetLastCommitForFiles, FColor::Red);
-	
-	const FString Command = TEXT("log");
-	FString Result;
-	FString Errors;
+	ActiveDiffCount.Decrement();
+}
 
-	TArray<FString> Params;
-	Params.Add(InBranch);
-	Params.Add(TEXT("--pretty=format:\"<Hash:%h> <Message:%s> <Author:%an> <Date:%ad>\""));
-	Params.Add(TEXT("--date=format-local:\"%d/%m/%Y %H:%M\""));
-	Params.Add(TEXT("--name-status"));
+TOptional<FString> UDiffHelperGitManager::GetFile(const FString& InFilename, const FString& InRevision) const
+{
+	SCOPED_NAMED_EVENT(UDiffHelperGitManager_GetFile, FColor::Red);
 
-	const auto FileList = Algo::Accumulate(InFilePaths, FString("-- "), [](FString Accumulator, const FString& FilePath)
+	// Called from worker threads for prefetching and parallel extraction of both diff sides
+	if (bShuttingDown || !ensure(BlobCache.IsValid()))
 	{
-		Accumulator += FilePath;
-		Accumulator += TEXT(" ");
-		return Accumulator;
-	});
+		return {};
+	}
 
-	Params.Add(FileList);
+	ActiveDiffCount.Increment();
+	ON_SCOPE_EXIT { ActiveDiffCount.Decrement(); };
 
-	if (!ExecuteCommand(Command, Params, {}, Result, Errors))
+	// Files are cached by blob hash, so the same content in different revisions and folders is extracted once
+	const auto ObjectInfo = GetObjectInfo(InFilename, InRevision);
+	if (!ObjectInfo.IsSet() || ObjectInfo->Type != TEXT("blob"))
 	{
-		UE_LOG(LogDiffHelper, Error, TEXT("Failed to get last commit for files: %s"), *Errors);
+		UE_LOG(LogDiffHelper, Error, TEXT("Failed to find blob for '%s:%s'"), *InRevision, *InFilename);
 		return {};
 	}
 
-	TMap<FString, FDiffHelperCommit> LastCommits;
-	TArray<FDiffHelperCommit> Commits = ParseCommits(Result);
-	for (const auto& Commit : Commits)
+	const auto Extension = FPaths::GetExtension(InFilename, true);
+	BlobCache->SetByteBudget(GetDefault<UDiffHelperSettings>()->BlobCacheSizeMB * 1024ll * 1024ll);
+
+	const auto ExtractionKey = ObjectInfo->Hash + Extension;
+	TPromise<TOptional<FString>> ExtractionPromise;
+	TOptional<TSharedFuture<TOptional<FString>>> PendingExtraction;
 	{
-		for (const auto& File : Commit.Files)
+		FScopeLock ScopeLock(&ExtractionsCriticalSection);
+
+		auto CachedPath = BlobCache->Find(ObjectInfo->Hash, Extension);
+		FDiffHelperStats::Get().RecordBlobCache(CachedPath.IsSet());
+
+		if (CachedPath.IsSet())
 		{
-			if (LastCommits.Contains(File.Path))
-			{
-				continue;
-			}
+			return CachedPath;
+		}
 
-			LastCommits.Add(File.Path, Commit);
+		// Prefetch could start extracting the same blob already, waiting for it is cheaper than running git again
+		if (const auto* Extraction = PendingExtractions.Find(ExtractionKey))
+		{
+			PendingExtraction = *Extraction;
+		}
+		else
+		{
+			PendingExtractions.Add(ExtractionKey, ExtractionPromise.GetFuture().Share());
 		}
 	}
-	
-	return LastCommits;
-}
 
-void UDiffHelperGitManager::LoadGitBinaryPath()
-{
-	SCOPED_NAMED_EVENT(UDiffHelperGitManager_LoadGitBinaryPath, FColor::Red);
-	
-	FScopeLock ScopeLock(&CriticalSection);
+	if (PendingExtraction.IsSet())
+	{
+		return PendingExtraction->Get();
+	}
 
-	static const FString SettingsSection = TEXT("GitSourceControl.GitSourceControlSettings");
-	const auto& IniFile = SourceControlHelpers::GetSettingsIni();
-	const auto Result = GConfig->GetString(*SettingsSection, TEXT("BinaryPath"), GitBinaryPath, IniFile);
-	
-	if (!Result)
+	const auto Result = ExtractBlob(ObjectInfo.GetValue(), InFilename, InRevision, Extension);
 	{
-		UDiffHelperUtils::AddErrorNotification(LOCTEXT("GitBinaryPathError", "Couldn't obtain git binary path! Check your Revision Control settings!"));
+		FScopeLock ScopeLock(&ExtractionsCriticalSection);
+		PendingExtractions.Remove(ExtractionKey);
 	}
-}
 
-TOptional<FString> UDiffHelperGitManager::GetRepositoryDirectory() const
-{
-#if ENGINE_MAJOR_VERSION >= 5 && ENGINE_MINOR_VERSION >= 3
-	const auto& Provider = ISourceControlModule::Get().GetProvider();
-	const auto Status = Provider.GetStatus();
-	return Status.Contains(ISourceControlProvider::EStatus::Repository) ? TOptional<FString>(Status[ISourceControlProvider::EStatus::Repository]) : TOptional<FString>();
-#else
-	// Repository root is inaccessible in 5.2 and below
-	return TOptional<FString>(FPaths::ConvertRelativePathToFull(FPaths::ProjectDir()));
-#endif
+	ExtractionPromise.SetValue(Result);
+	return Result;
 }
 
-bool UDiffHelperGitManager::ExecuteCommand(const FString& InCommand, const TArray<FString>& InParameters, const TArray<FString>& InFiles, FString& OutResults, FString& OutErrors) const
+TOptional<FString> UDiffHelperGitManager::ExtractBlob(const FDiffHelperGitObjectInfo& InObjectInfo, const FString& InFilename, const FString& InRevision, const FString& InExtension) const
 {
-	SCOPED_NAMED_EVENT_F(TEXT("UDiffHelperGitManager_ExecuteCommand: %s"), FColor::Red, *InCommand);
-	
-	const auto RepositoryRoot = GetRepositoryDirectory().GetValue();
+	SCOPED_NAMED_EVENT(UDiffHelperGitManager_ExtractBlob, FColor::Red);
+	DIFFHELPER_TRACE_SCOPE(DiffHelper_ExtractBlob);
 
-	int32 ReturnCode = -1;
-	FString FullCommand = InCommand;
+	const auto TempPath = BlobCache->MakeTempPath();
 
-	for (const auto& Parameter : InParameters)
+	// Contents are written as they are read, the blob size can't tell how big the file is, e.g. an LFS pointer smudges into a whole asset
+	bool bCommandSuccessful = false;
+	bool bBlobRead = false;
 	{
-		FullCommand += TEXT(" ");
-		FullCommand += Parameter;
+		const TUniquePtr<FArchive> Writer(IFileManager::Get().CreateFileWriter(*TempPath));
+		if (Writer.IsValid() && ReadBlob(InObjectInfo.Hash, InFilename, *Writer))
+		{
+			bBlobRead = true;
+			bCommandSuccessful = Writer->Close();
+		}
 	}
 
-	FPlatformProcess::ExecProcess(*GitBinaryPath, *FullCommand, &ReturnCode, &OutResults, &OutErrors, *RepositoryRoot);
-
-	return ReturnCode == 0;
-}
-
-TOptional<FString> UDiffHelperGitManager::GetForkPoint(const FDiffHelperBranch& InSourceBranch, const FDiffHelperBranch& InTargetBranch) const
-{
-	SCOPED_NAMED_EVENT(UDiffHelperGitManager_GetForkPoint, FColor::Red);
-	
-	const auto Command = FString::Printf(TEXT("rev-parse --short \"$(git rev-list %s ^%s | tail -n 1)^\""), *InSourceBranch.Name, *InTargetBranch.Name);
-	FString Result;
-	FString Errors;
+	if (!bBlobRead)
+	{
+		// Fallback to one-shot git process if persistent worker is unavailable or busy with the other diff side
+		const FString Parameter = FString::Printf(TEXT("%s:%s"), *InRevision, *InFilename);
+		bCommandSuccessful = ExtractFile(Parameter, TempPath);
+	}
 
-	if (!ExecuteCommand(Command, {}, {}, Result, Errors))
+	if (!bCommandSuccessful)
 	{
-		UE_LOG(LogDiffHelper, Error, TEXT("Failed to get fork point: %s"), *Errors);
-		return TOptional<FString>();
+		IFileManager::Get().Delete(*TempPath, false, false, true);
+		return {};
 	}
 
-	return TOptional(Result.TrimStartAndEnd());
+	return BlobCache->Add(InObjectInfo.Hash, InExtension, TempPath);
 }
 
-TMap<FString, EDiffHelperFileStatus> UDiffHelperGitManager::GetStatuses(const FString& InSourceRevision, const FString& InTargetRevision) const
+void UDiffHelperGitManager::RefreshHistoryIndex()
 {
-	SCOPED_NAMED_EVENT(UDiffHelperGitManager_GetStatuses, FColor::Red);
-	
-	const auto Command = TEXT("diff");
-	FString Result;
-	FString Errors;
-
-	TArray<FString> Params;
-	Params.Add(TEXT("--name-status"));
-	Params.Add(InTargetRevision + TEXT("..") + InSourceRevision);
+	SCOPED_NAMED_EVENT(UDiffHelperGitManager_RefreshHistoryIndex, FColor::Red);
 
-	if (!ExecuteCommand(Command, Params, {}, Result, Errors))
+	const auto RepositoryRoot = GetRepositoryDirectory();
+	if (!RepositoryRoot.IsSet() || bRefreshingCommitGraph)
 	{
-		UE_LOG(LogDiffHelper, Error, TEXT("Failed to get statuses: %s"), *Errors);
-		return {};
+		return;
 	}
 
-	const auto* Settings = GetDefault<UDiffHelperSettings>();
-	const auto Pattern = FRegexPattern(Settings->ChangedFilePattern);
-	auto Matcher = FRegexMatcher(Pattern, Result);
+	bRefreshingCommitGraph = true;
 
-	TMap<FString, EDiffHelperFileStatus> Statuses;
-	while (Matcher.FindNext())
+	// Writing could take minutes on big repositories, so the task doesn't block Deinit and only reports back if the manager is still alive
+	const TWeakObjectPtr<UDiffHelperGitManager> WeakThis = this;
+	Async(EAsyncExecution::ThreadPool, [GitBinary = GitBinaryPath, RepositoryRootPath = RepositoryRoot.GetValue(), WeakThis]()
 	{
-		const auto Status = Matcher.GetCaptureGroup(Settings->ChangedFileStatusGroup);
-		const auto Path = Matcher.GetCaptureGroup(Settings->ChangedFilePathGroup);
+		const double WalkTimeBefore = MeasurePathLimitedWalk(GitBinary, RepositoryRootPath);
+		const auto WriteResult = RunCommand(GitBinary, RepositoryRootPath, TEXT("commit-graph write --reachable --changed-paths"));
+		const double WalkTimeAfter = WriteResult.bSuccess ? MeasurePathLimitedWalk(GitBinary, RepositoryRootPath) : 0.0;
 
-		Statuses.Add(Path, ConvertFileStatus(Status));
-	}
+		if (WriteResult.bSuccess)
+		{
+			UE_LOG(LogDiffHelper, Display, TEXT("Commit-graph written in %.3fs, path-limited history walk: %.3fs before, %.3fs after"), WriteResult.Duration, WalkTimeBefore, WalkTimeAfter);
+		}
+
+		AsyncTask(ENamedThreads::GameThread, [WeakThis, bSuccess = WriteResult.bSuccess, Errors = WriteResult.Errors]()
+		{
+			if (WeakThis.IsValid())
+			{
+				WeakThis->bRefreshingCommitGraph = false;
+			}
+
+			if (bSuccess)
+			{
+				FNotificationInfo Info(LOCTEXT("CommitGraphWritten", "Git commit-graph has been refreshed"));
+				Info.ExpireDuration = GetDefault<UDiffHelperSettings>()->ErrorExpireDuration;
+				FSlateNotificationManager::Get().AddNotification(Info);
+			}
+			else
+			{
+				// Changed-path Bloom filters need git 2.27 or newer
+				UDiffHelperUtils::AddErrorNotification(FText::Format(LOCTEXT("CommitGraphWriteFailed", "Failed to write git commit-graph: {0}"), FText::FromString(Errors)));
+			}
+		});
+	});
+}
+
+FDiffHelperCommitGraphStatus UDiffHelperGitManager::GetCommitGraphStatus() const
+{
+	SCOPED_NAMED_EVENT(UDiffHelperGitManager_GetCommitGraphStatus, FColor::Red);
+
+	FDiffHelperCommitGraphStatus Status;
+	if (ObjectsInfoDirectory.IsEmpty())
+	{
+		return Status;
+	}
+
+	// Single file written by default, or a chain of layers written with --split
+	const auto SingleGraphPath = FPaths::Combine(ObjectsInfoDirectory, TEXT("commit-graph"));
+	if (DiffHelperGitManager::ReadCommitGraphChunks(SingleGraphPath, Status.bHasChangedPaths))
+	{
+		Status.bExists = true;
+		return Status;
+	}
+
+	const auto ChainDirectory = FPaths::Combine(ObjectsInfoDirectory, TEXT("commit-graphs"));
+	TArray<FString> Layers;
+	if (!FFileHelper::LoadFileToStringArray(Layers, *FPaths::Combine(ChainDirectory, TEXT("commit-graph-chain"))))
+	{
+		return Status;
+	}
+
+	Status.bHasChangedPaths = true;
+	for (const auto& Layer : Layers)
+	{
+		bool bLayerHasChangedPaths = false;
+		if (!Layer.IsEmpty() && DiffHelperGitManager::ReadCommitGraphChunks(FPaths::Combine(ChainDirectory, FString::Printf(TEXT("graph-%s.graph"), *Layer)), bLayerHasChangedPaths))
+		{
+			Status.bExists = true;
+			Status.bHasChangedPaths &= bLayerHasChangedPaths;
+		}
+	}
+
+	Status.bHasChangedPaths &= Status.bExists;
+	return Status;
+}
+
+TOptional<FString> UDiffHelperGitManager::FindObjectsInfoDirectory() const
+{
+	if (!GetRepositoryDirectory().IsSet())
+	{
+		return {};
+	}
+
+	FString Result;
+	FString Errors;
+	if (!ExecuteCommand(TEXT("rev-parse"), {TEXT("--git-path objects/info")}, {}, Result, Errors))
+	{
+		UE_LOG(LogDiffHelper, Warning, TEXT("Failed to find git objects directory: %s"), *Errors);
+		return {};
+	}
+
+	// Path is relative to the repository root, unless the repository uses a separate git directory
+	auto Path = Result.TrimStartAndEnd();
+	if (FPaths::IsRelative(Path))
+	{
+		Path = FPaths::Combine(GetRepositoryDirectory().Get(FString()), Path);
+	}
+
+	return Path;
+}
+
+double UDiffHelperGitManager::MeasurePathLimitedWalk(const FString& InGitBinaryPath, const FString& InRepositoryRoot)
+{
+	const auto Command = FString::Printf(TEXT("--literal-pathspecs rev-list --count HEAD -- %s"), *DiffHelperGitManager::WalkProbePath);
+	return RunCommand(InGitBinaryPath, InRepositoryRoot, Command).Duration;
+}
+
+void UDiffHelperGitManager::SetRepositoryOverride(const FString& InRepositoryRoot, const FString& InGitBinaryPath)
+{
+	RepositoryRootOverride = InRepositoryRoot;
+	GitBinaryPathOverride = InGitBinaryPath;
+}
+
+TMap<FString, TSharedPtr<FDiffHelperCommit>> UDiffHelperGitManager::GetLastCommitForFiles(const TArray<FString>& InFilePaths, const FString& InBranch) const
+{
+	SCOPED_NAMED_EVENT(UDiffHelperGitManager_GetLastCommitForFiles, FColor::Red);
+
+	auto Result = QueryLastCommits(InFilePaths, InBranch);
+	if (!Result.bSuccess)
+	{
+		UE_LOG(LogDiffHelper, Error, TEXT("Failed to get last commit for files: %s"), *Result.Errors);
+	}
+
+	return MoveTemp(Result.LastCommits);
+}
+
+FDiffHelperLastCommitsResult UDiffHelperGitManager::QueryLastCommits(const TArray<FString>& InFilePaths, const FString& InBranch, const TSharedPtr<FThreadSafeBool>& InCancellationFlag) const
+{
+	SCOPED_NAMED_EVENT(UDiffHelperGitManager_QueryLastCommits, FColor::Red);
+	DIFFHELPER_TRACE_SCOPE(DiffHelper_QueryLastCommits);
+
+	FDiffHelperLastCommitsResult Result;
+	Result.bSuccess = true;
+
+	if (InFilePaths.Num() == 0)
+	{
+		return Result;
+	}
+
+	const double StartTime = FPlatformTime::Seconds();
+
+	struct FBatchResult
+	{
+		bool bSuccess = false;
+		TArray<FDiffHelperCommit> Commits;
+		FString Errors;
+	};
+
+	Result.BatchCount = FMath::Clamp(FMath::DivideAndRoundUp(InFilePaths.Num(), DiffHelperGitManager::MinLastCommitsBatchSize), 1, DiffHelperGitManager::MaxLastCommitsBatchCount);
+	const int32 BatchSize = FMath::DivideAndRoundUp(InFilePaths.Num(), Result.BatchCount);
+
+	// Batches are awaited below, so the tasks don't outlive the manager. Each one mostly waits for its git process,
+	// so they get own threads instead of blocking pool threads the caller could be waiting on
+	TArray<TFuture<FBatchResult>> BatchFutures;
+	for (int32 BatchStart = 0; BatchStart < InFilePaths.Num(); BatchStart += BatchSize)
+	{
+		TArray<FString> BatchPaths(InFilePaths.GetData() + BatchStart, FMath::Min(BatchSize, InFilePaths.Num() - BatchStart));
+		BatchFutures.Add(Async(EAsyncExecution::Thread, [this, BatchPaths = MoveTemp(BatchPaths), InBranch, InCancellationFlag]()
+		{
+			FBatchResult BatchResult;
+			BatchResult.bSuccess = RunLastCommitsBatch(BatchPaths, InBranch, InCancellationFlag, BatchResult.Commits, BatchResult.Errors);
+			return BatchResult;
+		}));
+	}
+
+	// Batches walk the same history, so one commit can come from several of them with different files
+	TMap<FString, TSharedPtr<FDiffHelperCommit>> CommitsByRevision;
+	for (auto& BatchFuture : BatchFutures)
+	{
+		const auto& BatchResult = BatchFuture.Get();
+		Result.bSuccess &= BatchResult.bSuccess;
+		Result.Errors += BatchResult.Errors;
+
+		// Decided before merging, a merged commit lists files of other batches, which could remap them to an older commit
+		const auto LastRevisions = CollectLastRevisions(BatchResult.Commits);
+
+		for (const auto& Commit : BatchResult.Commits)
+		{
+			if (const auto* ExistingCommit = CommitsByRevision.Find(Commit.Revision))
+			{
+				(*ExistingCommit)->Files.Append(Commit.Files);
+			}
+			else
+			{
+				CommitsByRevision.Add(Commit.Revision, MakeShared<FDiffHelperCommit>(Commit));
+			}
+		}
+
+		// Paths of different batches don't overlap, so keys added here are new
+		for (const auto& LastRevision : LastRevisions)
+		{
+			Result.LastCommits.Add(LastRevision.Key, CommitsByRevision.FindChecked(LastRevision.Value));
+		}
+	}
+
+	Result.Duration = FPlatformTime::Seconds() - StartTime;
+	return Result;
+}
+
+bool UDiffHelperGitManager::RunLastCommitsBatch(const TArray<FString>& InFilePaths, const FString& InBranch, const TSharedPtr<FThreadSafeBool>& InCancellationFlag, TArray<FDiffHelperCommit>& OutCommits, FString& OutErrors) const
+{
+	SCOPED_NAMED_EVENT(UDiffHelperGitManager_RunLastCommitsBatch, FColor::Red);
+
+	const auto RepositoryRoot = GetRepositoryDirectory();
+	if (!RepositoryRoot.IsSet())
+	{
+		return false;
+	}
+
+	// Paths go through stdin instead of the command line, so a big diff can't overflow the command line length limit
+	FDiffHelperGitProcess Process(GitBinaryPath, RepositoryRoot.GetValue());
+	Process.SetCancellationFlag(InCancellationFlag);
+	if (!Process.Launch(MakeFullCommand(TEXT("--literal-pathspecs log"), MakeLogParameters({TEXT("--stdin")})), true))
+	{
+		return false;
+	}
+
+	// Revisions come first, paths follow the "--" line
+	FString Input = InBranch + TEXT("\n--\n");
+	for (const auto& Path : InFilePaths)
+	{
+		Input += Path;
+		Input += TEXT("\n");
+	}
+
+	if (!Process.Write(Input))
+	{
+		Process.ReadErrors(OutErrors);
+		return false;
+	}
+
+	Process.CloseInput();
+
+	// Regex patterns of dev mode need the whole output, so only the tokenizer can stop the walk early
+	const bool bIncrementalParsing = !GetDefault<UDiffHelperSettings>()->bDevMode;
+	TSet<FString> UnresolvedPaths(InFilePaths);
+
+	TArray<uint8> Output;
+	TArray<uint8> Chunk;
+	while (Process.ReadOutputChunk(Chunk, OutErrors))
+	{
+		Output.Append(Chunk);
+
+		if (!bIncrementalParsing)
+		{
+			continue;
+		}
+
+		// Only records followed by the next record separator are complete
+		const int32 LastRecordStart = Output.FindLast(DiffHelperGitFormat::RecordSeparator);
+		if (LastRecordStart <= 0)
+		{
+			continue;
+		}
+
+		auto Commits = FDiffHelperGitParser::ParseCommits(TArrayView<const uint8>(Output.GetData(), LastRecordStart));
+		Output.RemoveAt(0, LastRecordStart, false);
+
+		for (const auto& Commit : Commits)
+		{
+			for (const auto& File : Commit.Files)
+			{
+				UnresolvedPaths.Remove(File.Path);
+			}
+		}
+
+		OutCommits.Append(MoveTemp(Commits));
+
+		if (UnresolvedPaths.Num() == 0)
+		{
+			// Older history can't change the result anymore
+			Process.Terminate();
+			return true;
+		}
+	}
+
+	const int32 ReturnCode = Process.WaitForExit();
+	Process.ReadErrors(OutErrors);
+
+	OutCommits.Append(ParseLogOutput(Output));
+	return ReturnCode == 0;
+}
+
+TOptional<FDiffHelperGitObjectInfo> UDiffHelperGitManager::GetObjectInfo(const FString& InFilePath, const FString& InRevision) const
+{
+	SCOPED_NAMED_EVENT(UDiffHelperGitManager_GetObjectInfo, FColor::Red);
+
+	const auto ObjectName = FString::Printf(TEXT("%s:%s"), *InRevision, *InFilePath);
+	if (ObjectInfoWorker.IsValid() && ObjectInfoWorker->IsAvailable())
+	{
+		return ObjectInfoWorker->GetObjectInfo(ObjectName);
+	}
+
+	// Fallback: "<mode> <type> <hash> <size>\t<path>"
+	FString Result;
+	FString Errors;
+
+	TArray<FString> Params;
+	Params.Add(TEXT("-l"));
+	Params.Add(InRevision);
+	Params.Add(TEXT("-- \"") + InFilePath + TEXT("\""));
+
+	if (!ExecuteCommand(TEXT("ls-tree"), Params, {}, Result, Errors))
+	{
+		UE_LOG(LogDiffHelper, Error, TEXT("Failed to get object info for %s: %s"), *ObjectName, *Errors);
+		return {};
+	}
+
+	FString Metadata;
+	if (!Result.Split(TEXT("\t"), &Metadata, nullptr))
+	{
+		return {};
+	}
+
+	TArray<FString> Tokens;
+	Metadata.ParseIntoArrayWS(Tokens);
+	if (Tokens.Num() != 4)
+	{
+		return {};
+	}
+
+	FDiffHelperGitObjectInfo Info;
+	Info.Type = Tokens[1];
+	Info.Hash = Tokens[2];
+	Info.Size = FCString::Atoi64(*Tokens[3]);
+
+	return Info;
+}
+
+void UDiffHelperGitManager::LoadGitBinaryPath()
+{
+	SCOPED_NAMED_EVENT(UDiffHelperGitManager_LoadGitBinaryPath, FColor::Red);
+	
+	FScopeLock ScopeLock(&CriticalSection);
+
+	if (!GitBinaryPathOverride.IsEmpty())
+	{
+		GitBinaryPath = GitBinaryPathOverride;
+		return;
+	}
+
+	static const FString SettingsSection = TEXT("GitSourceControl.GitSourceControlSettings");
+	const auto& IniFile = SourceControlHelpers::GetSettingsIni();
+	const auto Result = GConfig->GetString(*SettingsSection, TEXT("BinaryPath"), GitBinaryPath, IniFile);
+	
+	if (!Result)
+	{
+		UDiffHelperUtils::AddErrorNotification(LOCTEXT("GitBinaryPathError", "Couldn't obtain git binary path! Check your Revision Control settings!"));
+	}
+}
+
+TOptional<FString> UDiffHelperGitManager::GetRepositoryDirectory() const
+{
+	// Source control provider isn't thread-safe, so the root is only queried on the game thread
+	if (!RepositoryRoot.IsSet() && IsInGameThread())
+	{
+		RepositoryRoot = FindRepositoryDirectory();
+	}
+
+	return RepositoryRoot;
+}
+
+TOptional<FString> UDiffHelperGitManager::FindRepositoryDirectory() const
+{
+	if (!RepositoryRootOverride.IsEmpty())
+	{
+		return RepositoryRootOverride;
+	}
+
+#if ENGINE_MAJOR_VERSION >= 5 && ENGINE_MINOR_VERSION >= 3
+	const auto& Provider = ISourceControlModule::Get().GetProvider();
+	const auto Status = Provider.GetStatus();
+	return Status.Contains(ISourceControlProvider::EStatus::Repository) ? TOptional<FString>(Status[ISourceControlProvider::EStatus::Repository]) : TOptional<FString>();
+#else
+	// Repository root is inaccessible in 5.2 and below
+	return TOptional<FString>(FPaths::ConvertRelativePathToFull(FPaths::ProjectDir()));
+#endif
+}
+
+void UDiffHelperGitManager::StartWorkers()
+{
+	SCOPED_NAMED_EVENT(UDiffHelperGitManager_StartWorkers, FColor::Red);
+
+	if (!GetDefault<UDiffHelperSettings>()->bUsePersistentGitProcess)
+	{
+		return;
+	}
+
+	const auto RepositoryRoot = GetRepositoryDirectory();
+	if (!RepositoryRoot.IsSet())
+	{
+		return;
+	}
+
+	BlobWorker = MakeShared<FDiffHelperGitCatFileWorker>(GitBinaryPath, RepositoryRoot.GetValue(), EDiffHelperCatFileMode::Batch);
+	ObjectInfoWorker = MakeShared<FDiffHelperGitCatFileWorker>(GitBinaryPath, RepositoryRoot.GetValue(), EDiffHelperCatFileMode::BatchCheck);
+
+	if (!BlobWorker->Start() || !ObjectInfoWorker->Start())
+	{
+		UE_LOG(LogDiffHelper, Warning, TEXT("Failed to start git cat-file workers, falling back to one-shot git processes"));
+		StopWorkers();
+	}
+}
+
+void UDiffHelperGitManager::StopWorkers()
+{
+	if (BlobWorker.IsValid())
+	{
+		BlobWorker->Stop();
+		BlobWorker.Reset();
+	}
+
+	if (ObjectInfoWorker.IsValid())
+	{
+		ObjectInfoWorker->Stop();
+		ObjectInfoWorker.Reset();
+	}
+}
+
+bool UDiffHelperGitManager::ReadBlob(const FString& InBlobHash, const FString& InFilePath, FArchive& OutContent) const
+{
+	SCOPED_NAMED_EVENT(UDiffHelperGitManager_ReadBlob, FColor::Red);
+
+	if (!BlobWorker.IsValid() || !BlobWorker->IsAvailable())
+	{
+		return false;
+	}
+
+	FDiffHelperGitObjectInfo BlobInfo;
+	if (!BlobWorker->TryReadObject(InBlobHash, InFilePath, OutContent, BlobInfo))
+	{
+		return false;
+	}
+
+	UE_LOG(LogDiffHelper, Log, TEXT("Read '%s' %s (%lld bytes) via cat-file worker"), *InFilePath, *InBlobHash, BlobInfo.Size);
+	return true;
+}
+
+bool UDiffHelperGitManager::ExecuteCommand(const FString& InCommand, const TArray<FString>& InParameters, const TArray<FString>& InFiles, FString& OutResults, FString& OutErrors) const
+{
+	SCOPED_NAMED_EVENT_F(TEXT("UDiffHelperGitManager_ExecuteCommand: %s"), FColor::Red, *InCommand);
+	
+	const auto RepositoryRoot = GetRepositoryDirectory().GetValue();
+
+	int32 ReturnCode = -1;
+	FString FullCommand = InCommand;
+
+	for (const auto& Parameter : InParameters)
+	{
+		FullCommand += TEXT(" ");
+		FullCommand += Parameter;
+	}
+
+	FPlatformProcess::ExecProcess(*GitBinaryPath, *FullCommand, &ReturnCode, &OutResults, &OutErrors, *RepositoryRoot);
+	FDiffHelperStats::Get().RecordGitProcess();
+	FDiffHelperStats::Get().RecordBytesRead(FTCHARToUTF8(*OutResults).Length());
+
+	return ReturnCode == 0;
+}
+
+bool UDiffHelperGitManager::ExecuteCommandRaw(const FString& InCommand, const TArray<FString>& InParameters, TArray<uint8>& OutResults, FString& OutErrors) const
+{
+	SCOPED_NAMED_EVENT_F(TEXT("UDiffHelperGitManager_ExecuteCommandRaw: %s"), FColor::Red, *InCommand);
+
+	auto Result = RunCommand(GitBinaryPath, GetRepositoryDirectory().GetValue(), MakeFullCommand(InCommand, InParameters));
+	OutResults = MoveTemp(Result.Output);
+	OutErrors = MoveTemp(Result.Errors);
+
+	return Result.bSuccess;
+}
+
+TFuture<FDiffHelperGitCommandResult> UDiffHelperGitManager::ExecuteCommandAsync(const FString& InCommand, const TArray<FString>& InParameters, const TSharedPtr<FThreadSafeBool>& InCancellationFlag) const
+{
+	// Task captures everything by value, so it doesn't depend on the manager lifetime.
+	// Callers block on the result from pool tasks, so the command gets its own thread to never wait behind them
+	return Async(EAsyncExecution::Thread, [GitBinary = GitBinaryPath, RepositoryRootPath = GetRepositoryDirectory().Get(FString()), FullCommand = MakeFullCommand(InCommand, InParameters), InCancellationFlag]()
+	{
+		return RunCommand(GitBinary, RepositoryRootPath, FullCommand, InCancellationFlag);
+	});
+}
+
+FDiffHelperGitCommandResult UDiffHelperGitManager::RunCommand(const FString& InGitBinaryPath, const FString& InRepositoryRoot, const FString& InFullCommand, const TSharedPtr<FThreadSafeBool>& InCancellationFlag)
+{
+	SCOPED_NAMED_EVENT_F(TEXT("UDiffHelperGitManager_RunCommand: %s"), FColor::Red, *InFullCommand);
+	DIFFHELPER_TRACE_SCOPE(DiffHelper_RunCommand);
+
+	// ExecProcess converts output into FString and cuts it at the first NUL, so NUL-delimited output has to be read as bytes
+	FDiffHelperGitCommandResult Result;
+	const double StartTime = FPlatformTime::Seconds();
+
+	FDiffHelperGitProcess Process(InGitBinaryPath, InRepositoryRoot);
+	Process.SetCancellationFlag(InCancellationFlag);
+	if (Process.Launch(InFullCommand))
+	{
+		int32 ReturnCode = -1;
+		Result.bSuccess = Process.RunToCompletion(Result.Output, Result.Errors, ReturnCode);
+	}
+
+	Result.Duration = FPlatformTime::Seconds() - StartTime;
+	return Result;
+}
+
+FString UDiffHelperGitManager::MakeFullCommand(const FString& InCommand, const TArray<FString>& InParameters)
+{
+	FString FullCommand = InCommand;
+	for (const auto& Parameter : InParameters)
+	{
+		FullCommand += TEXT(" ");
+		FullCommand += Parameter;
+	}
+
+	return FullCommand;
+}
+
+bool UDiffHelperGitManager::ExecuteLog(const TArray<FString>& InParameters, TArray<FDiffHelperCommit>& OutCommits, FString& OutErrors) const
+{
+	SCOPED_NAMED_EVENT(UDiffHelperGitManager_ExecuteLog, FColor::Red);
+
+	TArray<uint8> Result;
+	if (!ExecuteCommandRaw(TEXT("log"), MakeLogParameters(InParameters), Result, OutErrors))
+	{
+		return false;
+	}
+
+	OutCommits = ParseLogOutput(Result);
+	return true;
+}
+
+TArray<FString> UDiffHelperGitManager::MakeLogParameters(const TArray<FString>& InParameters) const
+{
+	TArray<FString> Params;
+	if (GetDefault<UDiffHelperSettings>()->bDevMode)
+	{
+		Params.Add(TEXT("--pretty=format:\"<Hash:%h> <Message:%s> <Author:%an> <Date:%ct>\""));
+		Params.Add(TEXT("--name-status"));
+	}
+	else
+	{
+		Params.Add(DiffHelperGitFormat::CommitFormat);
+		Params.Add(TEXT("--name-status"));
+		Params.Add(DiffHelperGitFormat::NullTerminated);
+	}
+
+	Params.Append(InParameters);
+	return Params;
+}
+
+TArray<FString> UDiffHelperGitManager::MakeDiffCommitsParameters(const FString& InSourceRevision, const FString& InTargetRevision) const
+{
+	return { InTargetRevision + TEXT("..") + InSourceRevision };
+}
+
+TArray<FString> UDiffHelperGitManager::MakeCommitWalkParameters(const FString& InSourceRevision, const FString& InTargetRevision) const
+{
+	// Regex patterns of dev mode only understand --name-status
+	if (GetDefault<UDiffHelperSettings>()->bDevMode)
+	{
+		return MakeLogParameters(MakeDiffCommitsParameters(InSourceRevision, InTargetRevision));
+	}
+
+	// --raw entries carry modes and blob hashes as well, the parser keeps only the status and the path
+	TArray<FString> Params;
+	Params.Add(DiffHelperGitFormat::CommitFormat);
+	Params.Add(TEXT("--raw"));
+	Params.Add(DiffHelperGitFormat::NullTerminated);
+	Params.Append(MakeDiffCommitsParameters(InSourceRevision, InTargetRevision));
+	return Params;
+}
+
+TArray<FString> UDiffHelperGitManager::MakeStatusParameters(const FString& InSourceRevision, const FString& InTargetRevision) const
+{
+	TArray<FString> Params;
+	Params.Add(TEXT("--name-status"));
+
+	if (!GetDefault<UDiffHelperSettings>()->bDevMode)
+	{
+		Params.Add(DiffHelperGitFormat::NullTerminated);
+	}
+
+	Params.Add(InTargetRevision + TEXT("..") + InSourceRevision);
+	return Params;
+}
+
+TArray<FDiffHelperCommit> UDiffHelperGitManager::ParseLogOutput(const TArray<uint8>& InOutput) const
+{
+	if (GetDefault<UDiffHelperSettings>()->bDevMode)
+	{
+		return ParseCommits(FDiffHelperGitParser::ToString(FUtf8StringView(reinterpret_cast<const UTF8CHAR*>(InOutput.GetData()), InOutput.Num())));
+	}
+
+	return FDiffHelperGitParser::ParseCommits(InOutput);
+}
+
+TMap<FString, EDiffHelperFileStatus> UDiffHelperGitManager::ParseStatusOutput(const TArray<uint8>& InOutput) const
+{
+	SCOPED_NAMED_EVENT(UDiffHelperGitManager_ParseStatusOutput, FColor::Red);
+
+	const auto* Settings = GetDefault<UDiffHelperSettings>();
+	if (!Settings->bDevMode)
+	{
+		return FDiffHelperGitParser::ParseStatuses(InOutput);
+	}
+
+	const auto Output = FDiffHelperGitParser::ToString(FUtf8StringView(reinterpret_cast<const UTF8CHAR*>(InOutput.GetData()), InOutput.Num()));
+	const auto Pattern = Settings->GetRegexPattern(Settings->ChangedFilePattern);
+	auto Matcher = FRegexMatcher(Pattern, Output);
+
+	TMap<FString, EDiffHelperFileStatus> Statuses;
+	while (Matcher.FindNext())
+	{
+		const auto Status = Matcher.GetCaptureGroup(Settings->ChangedFileStatusGroup);
+		const auto Path = Matcher.GetCaptureGroup(Settings->ChangedFilePathGroup);
+
+		Statuses.Add(Path, ConvertFileStatus(Status));
+	}
 
 	return Statuses;
 }
 
+TMap<FString, FString> UDiffHelperGitManager::CollectLastRevisions(const TArray<FDiffHelperCommit>& InCommits) const
+{
+	// Log is sorted from newest to oldest, so the first commit touching a file is the last one
+	TMap<FString, FString> LastRevisions;
+	for (const auto& Commit : InCommits)
+	{
+		for (const auto& File : Commit.Files)
+		{
+			if (LastRevisions.Contains(File.Path))
+			{
+				continue;
+			}
+
+			LastRevisions.Add(File.Path, Commit.Revision);
+		}
+	}
+	
+	return LastRevisions;
+}
+
+TOptional<FString> UDiffHelperGitManager::GetForkPoint(const FDiffHelperBranch& InSourceBranch, const FDiffHelperBranch& InTargetBranch) const
+{
+	SCOPED_NAMED_EVENT(UDiffHelperGitManager_GetForkPoint, FColor::Red);
+	
+	const auto Command = FString::Printf(TEXT("rev-parse --short \"$(git rev-list %s ^%s | tail -n 1)^\""), *InSourceBranch.Name, *InTargetBranch.Name);
+	FString Result;
+	FString Errors;
+
+	if (!ExecuteCommand(Command, {}, {}, Result, Errors))
+	{
+		UE_LOG(LogDiffHelper, Error, TEXT("Failed to get fork point: %s"), *Errors);
+		return TOptional<FString>();
+	}
+
+	return TOptional(Result.TrimStartAndEnd());
+}
+
+TMap<FString, EDiffHelperFileStatus> UDiffHelperGitManager::GetStatuses(const FString& InSourceRevision, const FString& InTargetRevision) const
+{
+	SCOPED_NAMED_EVENT(UDiffHelperGitManager_GetStatuses, FColor::Red);
+	
+	TArray<uint8> Result;
+	FString Errors;
+
+	if (!ExecuteCommandRaw(TEXT("diff"), MakeStatusParameters(InSourceRevision, InTargetRevision), Result, Errors))
+	{
+		UE_LOG(LogDiffHelper, Error, TEXT("Failed to get statuses: %s"), *Errors);
+		return {};
+	}
+
+	return ParseStatusOutput(Result);
+}
+
 TArray<FDiffHelperBranch> UDiffHelperGitManager::ParseBranches(const FString& InBranches) const
 {
 	SCOPED_NAMED_EVENT(UDiffHelperGitManager_ParseBranches, FColor::Red);
 	
 	const auto* DiffHelperSettings = GetDefault<UDiffHelperSettings>();
-	const auto Pattern = FRegexPattern(DiffHelperSettings->BranchParserPattern);
+	const auto Pattern = DiffHelperSettings->GetRegexPattern(DiffHelperSettings->BranchParserPattern);
 	auto Matcher = FRegexMatcher(Pattern, InBranches);
 
 	TArray<FDiffHelperBranch> Branches;
@@ -457,8 +1367,8 @@ TArray<FDiffHelperCommit> UDiffHelperGitManager::ParseCommits(const FString& InC
 	TArray<FDiffHelperCommit> Commits;
 
 	const auto* Settings = GetDefault<UDiffHelperSettings>();
-	const auto CommitBlockPattern = FRegexPattern(Settings->CommitBlockPattern);
-	const auto CommitDataPattern = FRegexPattern(Settings->CommitDataPattern);
+	const auto CommitBlockPattern = Settings->GetRegexPattern(Settings->CommitBlockPattern);
+	const auto CommitDataPattern = Settings->GetRegexPattern(Settings->CommitDataPattern);
 
 	auto BlockMatcher = FRegexMatcher(CommitBlockPattern, InCommits);
 	while (BlockMatcher.FindNext())
@@ -484,49 +1394,15 @@ TArray<FDiffHelperCommit> UDiffHelperGitManager::ParseCommits(const FString& InC
 	return Commits;
 }
 
-FDiffHelperCommit UDiffHelperGitManager::ParseCommit(const FString& String) const
-{
-	SCOPED_NAMED_EVENT(UDiffHelperGitManager_ParseCommit, FColor::Red);
-	
-	const auto* Settings = GetDefault<UDiffHelperSettings>();
-	const auto Pattern = FRegexPattern(Settings->CommitDataPattern);
-	auto Matcher = FRegexMatcher(Pattern, String);
-
-	FDiffHelperCommit Commit;
-	if (Matcher.FindNext())
-	{
-		Commit.Revision = Matcher.GetCaptureGroup(Settings->HashGroup);
-		Commit.Message = Matcher.GetCaptureGroup(Settings->MessageGroup);
-		Commit.Author = Matcher.GetCaptureGroup(Settings->AuthorGroup);
-		Commit.Date = ParseDate(Matcher.GetCaptureGroup(Settings->DateGroup));
-
-		const auto ChangedFiles = Matcher.GetCaptureGroup(Settings->ChangedFilesGroup);
-		Commit.Files = ParseChangedFiles(ChangedFiles);
-	}
-
-	return Commit;
-}
-
 FDateTime UDiffHelperGitManager::ParseDate(const FString& InDate) const
 {
-	SCOPED_NAMED_EVENT(UDiffHelperGitManager_ParseDate, FColor::Red);
-	
-	const auto* Settings = GetDefault<UDiffHelperSettings>();
-	const auto Pattern = FRegexPattern(Settings->DatePattern);
-	auto Matcher = FRegexMatcher(Pattern, InDate);
-
-	if (Matcher.FindNext())
+	const auto TrimmedDate = InDate.TrimStartAndEnd();
+	if (!TrimmedDate.IsNumeric())
 	{
-		const auto Day = FCString::Atoi(*Matcher.GetCaptureGroup(Settings->DayGroup));
-		const auto Month = FCString::Atoi(*Matcher.GetCaptureGroup(Settings->MonthGroup));
-		const auto Year = FCString::Atoi(*Matcher.GetCaptureGroup(Settings->YearGroup));
-		const auto Hour = FCString::Atoi(*Matcher.GetCaptureGroup(Settings->HourGroup));
-		const auto Minute = FCString::Atoi(*Matcher.GetCaptureGroup(Settings->MinuteGroup));
-
-		return FDateTime(Year, Month, Day, Hour, Minute);
+		return {};
 	}
 
-	return {};
+	return FDateTime::FromUnixTimestamp(FCString::Atoi64(*TrimmedDate));
 }
 
 TArray<FDiffHelperFileData> UDiffHelperGitManager::ParseChangedFiles(const FString& InFiles) const
@@ -534,7 +1410,7 @@ TArray<FDiffHelperFileData> UDiffHelperGitManager::ParseChangedFiles(const FStri
 	SCOPED_NAMED_EVENT(UDiffHelperGitManager_ParseChangedFiles, FColor::Red);
 	
 	const auto* Settings = GetDefault<UDiffHelperSettings>();
-	const auto Pattern = FRegexPattern(Settings->ChangedFilePattern);
+	const auto Pattern = Settings->GetRegexPattern(Settings->ChangedFilePattern);
 	auto Matcher = FRegexMatcher(Pattern, InFiles);
 
 	TArray<FDiffHelperFileData> Files;
@@ -567,104 +1443,61 @@ EDiffHelperFileStatus UDiffHelperGitManager::ConvertFileStatus(const FString& In
 bool UDiffHelperGitManager::ExtractFile(const FString& InParameter, const FString& InDumpFileName) const
 {
 	SCOPED_NAMED_EVENT_F(TEXT("UDiffHelperGitManager_ExtractFile: %s"), FColor::Red, *InParameter);
-	
-	// Modified copy of GitSourceControlUtils::RunDumpToFile
-	// TODO: DIFF-24 - cleanup this method
-	int32 ReturnCode = -1;
-	FString FullCommand;
 
 	const auto RepositoryRoot = GetRepositoryDirectory();
 	if (!ensure(RepositoryRoot.IsSet()))
 	{
 		return false;
 	}
-	
-	// FGitSourceControlModule& GitSourceControl = FModuleManager::LoadModuleChecked<FGitSourceControlModule>("GitSourceControl");
-	// const FGitVersion& GitVersion = GitSourceControl.GetProvider().GetGitVersion();
 
-	if(!RepositoryRoot->IsEmpty())
+	const double StartTime = FPlatformTime::Seconds();
+
+	// --filters applies smudge filters used by Git LFS, git-fat, git-annex, etc
+	FDiffHelperGitProcess Process(GitBinaryPath, RepositoryRoot.GetValue());
+	if (!Process.Launch(TEXT("cat-file --filters ") + InParameter))
 	{
-		// Specify the working copy (the root) of the git repository (before the command itself)
-		FullCommand  = TEXT("-C \"");
-		FullCommand += *RepositoryRoot;
-		FullCommand += TEXT("\" ");
+		return false;
 	}
 
-	// then the git command itself
-	// if(GitVersion.bHasCatFileWithFilters)
-	// {
-		// Newer versions (2.9.3.windows.2) support smudge/clean filters used by Git LFS, git-fat, git-annex, etc
-		FullCommand += TEXT("cat-file --filters ");
-	// }
-	// else
-	// {
-		// Previous versions fall-back on "git show" like before
-		// FullCommand += TEXT("show ");
-	// }
-
-	// Append to the command the parameter
-	FullCommand += InParameter;
-
-	const bool bLaunchDetached = false;
-	const bool bLaunchHidden = true;
-	const bool bLaunchReallyHidden = bLaunchHidden;
-
-	void* PipeRead = nullptr;
-	void* PipeWrite = nullptr;
-
-	verify(FPlatformProcess::CreatePipe(PipeRead, PipeWrite));
+	const TUniquePtr<FArchive> Writer(IFileManager::Get().CreateFileWriter(*InDumpFileName));
+	if (!Writer.IsValid())
+	{
+		UE_LOG(LogDiffHelper, Error, TEXT("Could not open %s for writing"), *InDumpFileName);
+		return false;
+	}
 
-	FProcHandle ProcessHandle = FPlatformProcess::CreateProc(*GitBinaryPath, *FullCommand, bLaunchDetached, bLaunchHidden, bLaunchReallyHidden, nullptr, 0, **RepositoryRoot, PipeWrite, nullptr, nullptr);
-	if(ProcessHandle.IsValid())
+	// Chunks go to disk as they arrive, so big LFS files are never held in memory as a whole
+	int64 BytesReceived = 0;
+	TArray<uint8> Chunk;
+	FString Errors;
+	while (Process.ReadOutputChunk(Chunk, Errors))
 	{
-		FPlatformProcess::Sleep(0.01);
+		Writer->Serialize(Chunk.GetData(), Chunk.Num());
+		BytesReceived += Chunk.Num();
+	}
 
-		TArray<uint8> BinaryFileContent;
-		while(FPlatformProcess::IsProcRunning(ProcessHandle))
-		{
-			TArray<uint8> BinaryData;
-			FPlatformProcess::ReadPipeToArray(PipeRead, BinaryData);
-			if(BinaryData.Num() > 0)
-			{
-				BinaryFileContent.Append(MoveTemp(BinaryData));
-			}
-		}
-		TArray<uint8> BinaryData;
-		FPlatformProcess::ReadPipeToArray(PipeRead, BinaryData);
-		if(BinaryData.Num() > 0)
-		{
-			BinaryFileContent.Append(MoveTemp(BinaryData));
-		}
+	const bool bWriteSucceeded = Writer->Close();
+	const int32 ReturnCode = Process.WaitForExit();
+	Process.ReadErrors(Errors);
 
-		FPlatformProcess::GetProcReturnCode(ProcessHandle, &ReturnCode);
-		if(ReturnCode == 0)
-		{
-			// Save buffer into temp file
-			if(FFileHelper::SaveArrayToFile(BinaryFileContent, *InDumpFileName))
-			{
-				UE_LOG(LogDiffHelper, Log, TEXT("Writed '%s' (%do)"), *InDumpFileName, BinaryFileContent.Num());
-			}
-			else
-			{
-				UE_LOG(LogDiffHelper, Error, TEXT("Could not write %s"), *InDumpFileName);
-				ReturnCode = -1;
-			}
-		}
-		else
-		{
-			UE_LOG(LogDiffHelper, Error, TEXT("DumpToFile: ReturnCode=%d"), ReturnCode);
-		}
+	const double Duration = FPlatformTime::Seconds() - StartTime;
 
-		FPlatformProcess::CloseProc(ProcessHandle);
-	}
-	else
+	if (ReturnCode != 0)
 	{
-		UE_LOG(LogDiffHelper, Error, TEXT("Failed to launch 'git cat-file'"));
+		UE_LOG(LogDiffHelper, Error, TEXT("git cat-file %s failed with code %d: %s"), *InParameter, ReturnCode, *Errors);
+		return false;
 	}
 
-	FPlatformProcess::ClosePipe(PipeRead, PipeWrite);
+	const int64 FileSize = IFileManager::Get().FileSize(*InDumpFileName);
+	if (!bWriteSucceeded || FileSize != BytesReceived)
+	{
+		UE_LOG(LogDiffHelper, Error, TEXT("Could not write %s (%lld of %lld bytes written)"), *InDumpFileName, FileSize, BytesReceived);
+		return false;
+	}
 
-	return (ReturnCode == 0);
+	constexpr double BytesInMegabyte = 1024.0 * 1024.0;
+	UE_LOG(LogDiffHelper, Log, TEXT("Extracted %s to '%s' (%lld bytes) in %.3fs, %.1f MB/s"), *InParameter, *InDumpFileName, BytesReceived, Duration, Duration > 0.0 ? BytesReceived / BytesInMegabyte / Duration : 0.0);
+	return true;
 }
 
 #undef LOCTEXT_NAMESPACE
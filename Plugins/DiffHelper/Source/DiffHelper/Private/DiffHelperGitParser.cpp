@@ -0,0 +1,199 @@
+﻿// Copyright 2024 Gradess Games. All Rights Reserved.
+
+
+#include "DiffHelperGitParser.h"
+
+namespace DiffHelperGitParser
+{
+	using DiffHelperGitFormat::RecordSeparator;
+	constexpr uint8 FieldSeparator = 0x00;
+
+	struct FCursor
+	{
+		const uint8* Current;
+		const uint8* End;
+
+		explicit FCursor(const TArrayView<const uint8>& InData)
+			: Current(InData.GetData())
+			, End(InData.GetData() + InData.Num())
+		{
+		}
+
+		FORCEINLINE bool IsDone() const { return Current >= End; }
+		FORCEINLINE uint8 Peek() const { return *Current; }
+
+		// Returns everything up to the next NUL and skips the NUL itself
+		FUtf8StringView NextField()
+		{
+			const uint8* FieldStart = Current;
+			while (Current < End && *Current != FieldSeparator)
+			{
+				++Current;
+			}
+
+			const FUtf8StringView Field(reinterpret_cast<const UTF8CHAR*>(FieldStart), static_cast<int32>(Current - FieldStart));
+			if (Current < End)
+			{
+				++Current;
+			}
+
+			return Field;
+		}
+
+		// Skips separators git puts between header and file entries
+		void SkipPadding()
+		{
+			while (Current < End && (*Current == FieldSeparator || *Current == '\n'))
+			{
+				++Current;
+			}
+		}
+	};
+
+	// "--raw" entries start with ":<old mode> <new mode> <old hash> <new hash> <status>", the status goes last
+	FUtf8StringView ExtractStatus(const FUtf8StringView& InField)
+	{
+		if (InField.IsEmpty() || InField[0] != ':')
+		{
+			return InField;
+		}
+
+		for (int32 Index = InField.Len() - 1; Index > 0; Index--)
+		{
+			if (InField[Index] == ' ')
+			{
+				return InField.RightChop(Index + 1);
+			}
+		}
+
+		return InField;
+	}
+
+	// Reads "<status>\0<path>\0" entries, renames and copies are "<status>\0<old path>\0<new path>\0"
+	template<typename TCallback>
+	void ParseFileEntries(FCursor& InCursor, TCallback&& InCallback)
+	{
+		while (true)
+		{
+			InCursor.SkipPadding();
+			if (InCursor.IsDone() || InCursor.Peek() == RecordSeparator)
+			{
+				return;
+			}
+
+			const auto Status = ExtractStatus(InCursor.NextField());
+			auto Path = InCursor.NextField();
+
+			if (!Status.IsEmpty() && (Status[0] == 'R' || Status[0] == 'C'))
+			{
+				Path = InCursor.NextField();
+			}
+
+			if (!Path.IsEmpty())
+			{
+				InCallback(Status, Path);
+			}
+		}
+	}
+}
+
+TArray<FDiffHelperCommit> FDiffHelperGitParser::ParseCommits(const TArrayView<const uint8>& InOutput)
+{
+	SCOPED_NAMED_EVENT(FDiffHelperGitParser_ParseCommits, FColor::Red);
+
+	using namespace DiffHelperGitParser;
+
+	TArray<FDiffHelperCommit> Commits;
+	FCursor Cursor(InOutput);
+
+	while (!Cursor.IsDone())
+	{
+		if (Cursor.Peek() != RecordSeparator)
+		{
+			// Anything before the first record is noise
+			Cursor.Current++;
+			continue;
+		}
+
+		Cursor.Current++;
+
+		auto& Commit = Commits.AddDefaulted_GetRef();
+		Commit.Revision = ToString(Cursor.NextField());
+		Commit.Message = ToString(Cursor.NextField());
+		Commit.Author = ToString(Cursor.NextField());
+		Commit.Date = ParseDate(Cursor.NextField());
+
+		ParseFileEntries(Cursor, [&Commit](const FUtf8StringView& InStatus, const FUtf8StringView& InPath)
+		{
+			auto& FileData = Commit.Files.AddDefaulted_GetRef();
+			FileData.Path = ToString(InPath);
+			FileData.Status = ConvertFileStatus(InStatus);
+		});
+	}
+
+	return Commits;
+}
+
+TMap<FString, EDiffHelperFileStatus> FDiffHelperGitParser::ParseStatuses(const TArrayView<const uint8>& InOutput)
+{
+	SCOPED_NAMED_EVENT(FDiffHelperGitParser_ParseStatuses, FColor::Red);
+
+	using namespace DiffHelperGitParser;
+
+	TMap<FString, EDiffHelperFileStatus> Statuses;
+	FCursor Cursor(InOutput);
+
+	ParseFileEntries(Cursor, [&Statuses](const FUtf8StringView& InStatus, const FUtf8StringView& InPath)
+	{
+		Statuses.Add(ToString(InPath), ConvertFileStatus(InStatus));
+	});
+
+	return Statuses;
+}
+
+FDateTime FDiffHelperGitParser::ParseDate(const FUtf8StringView& InDate)
+{
+	if (InDate.IsEmpty())
+	{
+		return {};
+	}
+
+	int64 Timestamp = 0;
+	for (const auto Char : InDate)
+	{
+		if (Char < '0' || Char > '9')
+		{
+			return {};
+		}
+
+		Timestamp = Timestamp * 10 + (Char - '0');
+	}
+
+	return FDateTime::FromUnixTimestamp(Timestamp);
+}
+
+EDiffHelperFileStatus FDiffHelperGitParser::ConvertFileStatus(const FUtf8StringView& InStatus)
+{
+	if (InStatus.IsEmpty())
+	{
+		return EDiffHelperFileStatus::None;
+	}
+
+	// Renames and copies have a similarity score after the letter, e.g. R100
+	switch (InStatus[0])
+	{
+	case 'A': return EDiffHelperFileStatus::Added;
+	case 'M': return EDiffHelperFileStatus::Modified;
+	case 'D': return EDiffHelperFileStatus::Deleted;
+	case 'R': return EDiffHelperFileStatus::Renamed;
+	case 'C': return EDiffHelperFileStatus::Copied;
+	case 'U': return EDiffHelperFileStatus::Unmerged;
+	default: return EDiffHelperFileStatus::None;
+	}
+}
+
+FString FDiffHelperGitParser::ToString(const FUtf8StringView& InView)
+{
+	const FUTF8ToTCHAR Converter(reinterpret_cast<const ANSICHAR*>(InView.GetData()), InView.Len());
+	return FString(Converter.Length(), Converter.Get());
+}
@@ -0,0 +1,340 @@
+﻿// Copyright 2024 Gradess Games. All Rights Reserved.
+
+
+#include "DiffHelperGitProcess.h"
+#include "DiffHelperStats.h"
+#include "DiffHelperTypes.h"
+
+#if PLATFORM_UNIX
+#include <poll.h>
+#endif
+
+namespace DiffHelperGitProcess
+{
+	// Waits are bounded, so the exit of the child is noticed even if its pipes are kept open by another process
+	constexpr float WaitTimeout = 0.1f;
+
+#if PLATFORM_UNIX
+	// Returns false if the pipes can't be waited on and the caller has to sleep instead
+	bool PollPipes(void* InFirstPipe, void* InSecondPipe, const short InEvents, const float InTimeoutSeconds)
+	{
+		pollfd Descriptors[2];
+		int32 Count = 0;
+		for (void* Pipe : { InFirstPipe, InSecondPipe })
+		{
+			if (Pipe)
+			{
+				Descriptors[Count].fd = static_cast<FPipeHandle*>(Pipe)->GetHandle();
+				Descriptors[Count].events = InEvents;
+				Descriptors[Count].revents = 0;
+				++Count;
+			}
+		}
+
+		if (Count == 0 || poll(Descriptors, Count, FMath::CeilToInt(InTimeoutSeconds * 1000.0f)) < 0)
+		{
+			return false;
+		}
+
+		// A hung up pipe is always ready, so it would turn the caller's loop into a busy wait until the child is reaped
+		for (int32 Index = 0; Index < Count; ++Index)
+		{
+			if ((Descriptors[Index].revents & POLLHUP) && !(Descriptors[Index].revents & InEvents))
+			{
+				return false;
+			}
+		}
+
+		return true;
+	}
+#endif
+}
+
+FDiffHelperGitProcess::FDiffHelperGitProcess(const FString& InGitBinaryPath, const FString& InWorkingDirectory)
+	: GitBinaryPath(InGitBinaryPath)
+	, WorkingDirectory(InWorkingDirectory)
+{
+}
+
+FDiffHelperGitProcess::~FDiffHelperGitProcess()
+{
+	Terminate();
+}
+
+bool FDiffHelperGitProcess::Launch(const FString& InParameters, const bool bInRedirectInput)
+{
+	SCOPED_NAMED_EVENT_F(TEXT("FDiffHelperGitProcess_Launch: %s"), FColor::Red, *InParameters);
+
+	Terminate();
+
+	verify(FPlatformProcess::CreatePipe(StdOutRead, StdOutWrite));
+	verify(FPlatformProcess::CreatePipe(StdErrRead, StdErrWrite));
+
+	if (bInRedirectInput)
+	{
+		// Write end stays in our process, the child only inherits the read end
+		verify(FPlatformProcess::CreatePipe(StdInRead, StdInWrite, true));
+	}
+
+	const bool bLaunchDetached = false;
+	const bool bLaunchHidden = true;
+	const bool bLaunchReallyHidden = bLaunchHidden;
+
+	ProcessHandle = FPlatformProcess::CreateProc(*GitBinaryPath, *InParameters, bLaunchDetached, bLaunchHidden, bLaunchReallyHidden, nullptr, 0, *WorkingDirectory, StdOutWrite, StdInRead, StdErrWrite);
+
+	// Child ends are owned by the child process now
+	FPlatformProcess::ClosePipe(StdInRead, StdOutWrite);
+	FPlatformProcess::ClosePipe(nullptr, StdErrWrite);
+	StdInRead = nullptr;
+	StdOutWrite = nullptr;
+	StdErrWrite = nullptr;
+
+	if (!ProcessHandle.IsValid())
+	{
+		UE_LOG(LogDiffHelper, Error, TEXT("Failed to launch 'git %s'"), *InParameters);
+		ClosePipes();
+		return false;
+	}
+
+	FDiffHelperStats::Get().RecordGitProcess();
+	return true;
+}
+
+void FDiffHelperGitProcess::SetCancellationFlag(const TSharedPtr<FThreadSafeBool>& InCancellationFlag)
+{
+	CancellationFlag = InCancellationFlag;
+}
+
+bool FDiffHelperGitProcess::IsRunning()
+{
+	return ProcessHandle.IsValid() && FPlatformProcess::IsProcRunning(ProcessHandle);
+}
+
+void FDiffHelperGitProcess::Terminate()
+{
+	if (ProcessHandle.IsValid())
+	{
+		if (FPlatformProcess::IsProcRunning(ProcessHandle))
+		{
+			FPlatformProcess::TerminateProc(ProcessHandle);
+		}
+
+		FPlatformProcess::CloseProc(ProcessHandle);
+		ProcessHandle.Reset();
+	}
+
+	ClosePipes();
+}
+
+bool FDiffHelperGitProcess::Write(const FString& InText)
+{
+	const FTCHARToUTF8 Converter(*InText, InText.Len());
+	return Write(reinterpret_cast<const uint8*>(Converter.Get()), Converter.Length());
+}
+
+bool FDiffHelperGitProcess::Write(const uint8* InData, const int32 InSize)
+{
+	if (!StdInWrite || InSize <= 0)
+	{
+		return InSize == 0;
+	}
+
+	int32 TotalWritten = 0;
+	while (TotalWritten < InSize)
+	{
+		// WritePipe reports partial writes as failures, so the progress is tracked by the written size only
+		int32 Written = 0;
+		FPlatformProcess::WritePipe(StdInWrite, InData + TotalWritten, InSize - TotalWritten, &Written);
+
+		if (Written > 0)
+		{
+			TotalWritten += Written;
+			continue;
+		}
+
+		// Pipe is full until the child reads from it
+		if (CheckCancelled() || !IsRunning())
+		{
+			return false;
+		}
+
+		WaitForInput(DiffHelperGitProcess::WaitTimeout);
+	}
+
+	return true;
+}
+
+void FDiffHelperGitProcess::CloseInput()
+{
+	FPlatformProcess::ClosePipe(nullptr, StdInWrite);
+	StdInWrite = nullptr;
+}
+
+int32 FDiffHelperGitProcess::ReadOutput(TArray<uint8>& OutData)
+{
+	if (!StdOutRead)
+	{
+		return 0;
+	}
+
+	TArray<uint8> Chunk;
+	FPlatformProcess::ReadPipeToArray(StdOutRead, Chunk);
+
+	const int32 BytesRead = Chunk.Num();
+	OutData.Append(MoveTemp(Chunk));
+	FDiffHelperStats::Get().RecordBytesRead(BytesRead);
+
+	return BytesRead;
+}
+
+bool FDiffHelperGitProcess::ReadOutputChunk(TArray<uint8>& OutChunk, FString& OutErrors)
+{
+	OutChunk.Reset();
+
+	if (!StdOutRead)
+	{
+		return false;
+	}
+
+	// Pipe could stay open after the child exits, e.g. on Windows its write end is inherited by git processes launched concurrently,
+	// so the end of the output is detected by the exit of the process instead of a blocking read waiting for EOF
+	while (!CheckCancelled())
+	{
+		ReadErrors(OutErrors);
+
+		FPlatformProcess::ReadPipeToArray(StdOutRead, OutChunk);
+		if (OutChunk.Num() > 0)
+		{
+			FDiffHelperStats::Get().RecordBytesRead(OutChunk.Num());
+			return true;
+		}
+
+		if (!IsRunning())
+		{
+			FPlatformProcess::ReadPipeToArray(StdOutRead, OutChunk);
+			FDiffHelperStats::Get().RecordBytesRead(OutChunk.Num());
+			return OutChunk.Num() > 0;
+		}
+
+		WaitForOutput(DiffHelperGitProcess::WaitTimeout);
+	}
+
+	return false;
+}
+
+void FDiffHelperGitProcess::ReadErrors(FString& OutErrors)
+{
+	if (StdErrRead)
+	{
+		OutErrors += FPlatformProcess::ReadPipe(StdErrRead);
+	}
+}
+
+bool FDiffHelperGitProcess::RunToCompletion(TArray<uint8>& OutOutput, FString& OutErrors, int32& OutReturnCode)
+{
+	if (!ProcessHandle.IsValid())
+	{
+		OutReturnCode = -1;
+		return false;
+	}
+
+	CloseInput();
+
+	while (IsRunning())
+	{
+		if (CheckCancelled())
+		{
+			OutReturnCode = -1;
+			return false;
+		}
+
+		const int32 BytesRead = ReadOutput(OutOutput);
+		ReadErrors(OutErrors);
+
+		if (BytesRead == 0)
+		{
+			WaitForOutput(DiffHelperGitProcess::WaitTimeout);
+		}
+	}
+
+	// Drain whatever is left in the pipes after the process has exited
+	while (ReadOutput(OutOutput) > 0) {}
+	ReadErrors(OutErrors);
+
+	OutReturnCode = GetReturnCode();
+	return OutReturnCode == 0;
+}
+
+int32 FDiffHelperGitProcess::GetReturnCode()
+{
+	int32 ReturnCode = -1;
+	if (ProcessHandle.IsValid())
+	{
+		FPlatformProcess::GetProcReturnCode(ProcessHandle, &ReturnCode);
+	}
+
+	return ReturnCode;
+}
+
+int32 FDiffHelperGitProcess::WaitForExit()
+{
+	if (ProcessHandle.IsValid())
+	{
+		FPlatformProcess::WaitForProc(ProcessHandle);
+	}
+
+	return GetReturnCode();
+}
+
+bool FDiffHelperGitProcess::CheckCancelled()
+{
+	if (!CancellationFlag.IsValid() || !*CancellationFlag)
+	{
+		return false;
+	}
+
+	if (ProcessHandle.IsValid())
+	{
+		UE_LOG(LogDiffHelper, Log, TEXT("Git process cancelled"));
+		Terminate();
+	}
+
+	return true;
+}
+
+void FDiffHelperGitProcess::WaitForOutput(const float InTimeoutSeconds)
+{
+#if PLATFORM_UNIX
+	if (DiffHelperGitProcess::PollPipes(StdOutRead, StdErrRead, POLLIN, InTimeoutSeconds))
+	{
+		return;
+	}
+#endif
+
+	// Windows anonymous pipes don't support overlapped reads and a blocking ReadFile can't be interrupted by the exit of the child
+	// when the write end is inherited by another process, so the pipes are polled there
+	FPlatformProcess::Sleep(FMath::Min(InTimeoutSeconds, 0.001f));
+}
+
+void FDiffHelperGitProcess::WaitForInput(const float InTimeoutSeconds)
+{
+#if PLATFORM_UNIX
+	if (DiffHelperGitProcess::PollPipes(StdInWrite, nullptr, POLLOUT, InTimeoutSeconds))
+	{
+		return;
+	}
+#endif
+
+	FPlatformProcess::Sleep(FMath::Min(InTimeoutSeconds, 0.001f));
+}
+
+void FDiffHelperGitProcess::ClosePipes()
+{
+	FPlatformProcess::ClosePipe(StdOutRead, StdOutWrite);
+	FPlatformProcess::ClosePipe(StdErrRead, StdErrWrite);
+	FPlatformProcess::ClosePipe(StdInRead, StdInWrite);
+
+	StdOutRead = StdOutWrite = nullptr;
+	StdErrRead = StdErrWrite = nullptr;
+	StdInRead = StdInWrite = nullptr;
+}
@@ -2,6 +2,27 @@
 
 
 #include "DiffHelperManager.h"
+#include "DiffHelperTypes.h"
 
+bool FDiffHelperDiffContext::IsCancelled() const
+{
+	return CancellationFlag.IsValid() && *CancellationFlag;
+}
+
+void FDiffHelperDiffContext::ReportStage(const FText& InStage) const
+{
+	if (OnStageChanged && !IsCancelled())
+	{
+		OnStageChanged(InStage);
+	}
+}
+
+void FDiffHelperDiffContext::ReportBatch(TArray<FDiffHelperDiffItem>&& InItems) const
+{
+	if (OnBatchReady && !IsCancelled())
+	{
+		OnBatchReady(MoveTemp(InItems));
+	}
+}
 
 // Add default functionality here for any IIDiffHelperManager functions that are not pure virtual.
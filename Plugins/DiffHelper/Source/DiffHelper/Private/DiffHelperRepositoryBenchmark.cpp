@@ -0,0 +1,503 @@
+﻿// Copyright 2024 Gradess Games. All Rights Reserved.
+
+
+#include "DiffHelperGitManager.h"
+#include "DiffHelperGitProcess.h"
+#include "DiffHelperSettings.h"
+#include "DiffHelperTypes.h"
+#include "DiffHelperUtils.h"
+#include "SourceControlHelpers.h"
+#include "Dom/JsonObject.h"
+#include "HAL/FileManager.h"
+#include "HAL/IConsoleManager.h"
+#include "Interfaces/IPluginManager.h"
+#include "Math/RandomStream.h"
+#include "Misc/EngineVersion.h"
+#include "Misc/FileHelper.h"
+#include "Misc/ScopeExit.h"
+#include "Misc/TextFilter.h"
+#include "Serialization/JsonSerializer.h"
+
+namespace DiffHelperRepositoryBenchmark
+{
+	const FString SourceBranch = TEXT("feature");
+	const FString TargetBranch = TEXT("main");
+
+	// Written once the repository is complete, so an interrupted generation is started over
+	const FString GeneratedMarker = TEXT("DiffHelperGenerated");
+
+	// Package file tag, so blobs look like .uasset files to tools that check it
+	constexpr uint8 PackageTag[] = {0xC1, 0x83, 0x2A, 0x9E};
+	constexpr int32 PackageTagSize = UE_ARRAY_COUNT(PackageTag);
+
+	constexpr int32 StreamFlushSize = 4 * 1024 * 1024;
+	constexpr int32 RandomSeed = 2024;
+
+	struct FRepositoryParams
+	{
+		int32 CommitCount = 2000;
+		int32 FileCount = 5000;
+		// Number of subdirectories on each of the two directory levels
+		int32 FanOut = 10;
+		int32 BlobSize = 4096;
+		int32 FilesPerCommit = 5;
+		int32 Iterations = 3;
+
+		FString GetName() const
+		{
+			return FString::Printf(TEXT("c%d_f%d_o%d_b%d"), CommitCount, FileCount, FanOut, BlobSize);
+		}
+	};
+
+	struct FBenchmarkResult
+	{
+		FString Name;
+		int32 Iterations = 0;
+		double MinSeconds = 0.0;
+		double AverageSeconds = 0.0;
+		double MaxSeconds = 0.0;
+
+		// Number of branches, commits, items or nodes the last iteration returned
+		int32 ResultCount = 0;
+	};
+
+	FString GetBenchmarksDirectory()
+	{
+		return FPaths::Combine(FPaths::ProjectSavedDir(), TEXT("DiffHelper"), TEXT("Benchmarks"));
+	}
+
+	FString GetPluginVersion()
+	{
+		const auto Plugin = IPluginManager::Get().FindPlugin(TEXT("DiffHelper"));
+		return Plugin.IsValid() ? Plugin->GetDescriptor().VersionName : FString();
+	}
+
+	// Revision control settings are used when they are set up, headless runs usually have git on the default path
+	FString FindGitBinary()
+	{
+		FString GitBinaryPath;
+		GConfig->GetString(TEXT("GitSourceControl.GitSourceControlSettings"), TEXT("BinaryPath"), GitBinaryPath, SourceControlHelpers::GetSettingsIni());
+		if (!GitBinaryPath.IsEmpty())
+		{
+			return GitBinaryPath;
+		}
+
+		for (const auto* Candidate : {TEXT("/usr/bin/git"), TEXT("/usr/local/bin/git"), TEXT("/opt/homebrew/bin/git")})
+		{
+			if (FPaths::FileExists(Candidate))
+			{
+				return Candidate;
+			}
+		}
+
+		return FString();
+	}
+
+	FString GetAssetPath(const int32 InFileIndex, const int32 InFanOut)
+	{
+		return FString::Printf(TEXT("Content/Dir%d/Dir%d/Asset%d.uasset"), InFileIndex % InFanOut, (InFileIndex / InFanOut) % InFanOut, InFileIndex);
+	}
+
+	void AppendText(TArray<uint8>& OutStream, const FString& InText)
+	{
+		const FTCHARToUTF8 Converter(*InText, InText.Len());
+		OutStream.Append(reinterpret_cast<const uint8*>(Converter.Get()), Converter.Length());
+	}
+
+	void AppendBlob(TArray<uint8>& OutStream, FRandomStream& InRandom, const FString& InPath, const int32 InBlobSize)
+	{
+		const int32 BlobSize = FMath::Max(InBlobSize, PackageTagSize);
+		AppendText(OutStream, FString::Printf(TEXT("M 100644 inline %s\ndata %d\n"), *InPath, BlobSize));
+
+		// Random bytes don't compress or delta well, like real binary assets
+		OutStream.Append(PackageTag, PackageTagSize);
+		for (int32 Offset = PackageTagSize; Offset < BlobSize; Offset++)
+		{
+			OutStream.Add(static_cast<uint8>(InRandom.GetUnsignedInt()));
+		}
+
+		OutStream.Add('\n');
+	}
+
+	void AppendCommitHeader(TArray<uint8>& OutStream, const FString& InBranch, const int32 InMark, const int32 InFromMark, const FString& InMessage)
+	{
+		const int32 AuthorIndex = InMark % 16;
+		const int64 Timestamp = 1704067200ll + InMark * 60ll;
+		const FTCHARToUTF8 Message(*InMessage, InMessage.Len());
+
+		AppendText(OutStream, FString::Printf(TEXT("commit refs/heads/%s\nmark :%d\ncommitter Author %d <author%d@example.com> %lld +0000\ndata %d\n%s\n"),
+			*InBranch, InMark, AuthorIndex, AuthorIndex, Timestamp, Message.Length(), *InMessage));
+
+		if (InFromMark > 0)
+		{
+			AppendText(OutStream, FString::Printf(TEXT("from :%d\n"), InFromMark));
+		}
+	}
+
+	bool RunGit(const FString& InGitBinaryPath, const FString& InDirectory, const FString& InParameters)
+	{
+		FDiffHelperGitProcess Process(InGitBinaryPath, InDirectory);
+		if (!Process.Launch(InParameters))
+		{
+			return false;
+		}
+
+		TArray<uint8> Output;
+		FString Errors;
+		int32 ReturnCode = -1;
+		if (!Process.RunToCompletion(Output, Errors, ReturnCode) || ReturnCode != 0)
+		{
+			UE_LOG(LogDiffHelper, Error, TEXT("git %s failed: %s"), *InParameters, *Errors);
+			return false;
+		}
+
+		return true;
+	}
+
+	/**
+	 * Generates the repository with a single "git fast-import" stream:
+	 * "main" adds every file in the first commit and modifies random files in the next ones,
+	 * "feature" forks from main a fifth of the history before its end, modifies random files and adds new ones.
+	 */
+	bool GenerateRepository(const FString& InGitBinaryPath, const FString& InDirectory, const FRepositoryParams& InParams)
+	{
+		SCOPED_NAMED_EVENT(DiffHelperRepositoryBenchmark_GenerateRepository, FColor::Red);
+
+		auto& FileManager = IFileManager::Get();
+		FileManager.DeleteDirectory(*InDirectory, false, true);
+		FileManager.MakeDirectory(*InDirectory, true);
+
+		if (!RunGit(InGitBinaryPath, InDirectory, TEXT("init -q")) || !RunGit(InGitBinaryPath, InDirectory, TEXT("config gc.auto 0")))
+		{
+			return false;
+		}
+
+		FDiffHelperGitProcess Process(InGitBinaryPath, InDirectory);
+		if (!Process.Launch(TEXT("fast-import --quiet"), true))
+		{
+			return false;
+		}
+
+		FRandomStream Random(RandomSeed);
+		TArray<uint8> Stream;
+		Stream.Reserve(StreamFlushSize + InParams.BlobSize + 1024);
+
+		auto Flush = [&Process, &Stream](const bool bInForce)
+		{
+			if (Stream.Num() == 0 || (!bInForce && Stream.Num() < StreamFlushSize))
+			{
+				return true;
+			}
+
+			const bool bWritten = Process.Write(Stream.GetData(), Stream.Num());
+			Stream.Reset();
+			return bWritten;
+		};
+
+		const int32 FeatureCommitCount = FMath::Max(1, InParams.CommitCount / 5);
+		const int32 ForkMark = FMath::Max(1, InParams.CommitCount - FeatureCommitCount);
+
+		AppendCommitHeader(Stream, TargetBranch, 1, 0, TEXT("Initial commit"));
+		for (int32 FileIndex = 0; FileIndex < InParams.FileCount; FileIndex++)
+		{
+			AppendBlob(Stream, Random, GetAssetPath(FileIndex, InParams.FanOut), InParams.BlobSize);
+			if (!Flush(false))
+			{
+				return false;
+			}
+		}
+
+		for (int32 Mark = 2; Mark <= InParams.CommitCount; Mark++)
+		{
+			AppendCommitHeader(Stream, TargetBranch, Mark, 0, FString::Printf(TEXT("Update assets, commit %d"), Mark));
+			for (int32 Index = 0; Index < InParams.FilesPerCommit; Index++)
+			{
+				AppendBlob(Stream, Random, GetAssetPath(Random.RandHelper(InParams.FileCount), InParams.FanOut), InParams.BlobSize);
+			}
+
+			if (!Flush(false))
+			{
+				return false;
+			}
+		}
+
+		int32 NextFileIndex = InParams.FileCount;
+		for (int32 Index = 0; Index < FeatureCommitCount; Index++)
+		{
+			const int32 Mark = InParams.CommitCount + 1 + Index;
+			AppendCommitHeader(Stream, SourceBranch, Mark, Index == 0 ? ForkMark : 0, FString::Printf(TEXT("Feature work, commit %d"), Mark));
+
+			// Every fourth change adds a new asset, so the diff has both added and modified files
+			for (int32 FileIndex = 0; FileIndex < InParams.FilesPerCommit; FileIndex++)
+			{
+				const bool bAdd = (Index + FileIndex) % 4 == 0;
+				AppendBlob(Stream, Random, GetAssetPath(bAdd ? NextFileIndex++ : Random.RandHelper(InParams.FileCount), InParams.FanOut), InParams.BlobSize);
+			}
+
+			if (!Flush(false))
+			{
+				return false;
+			}
+		}
+
+		AppendText(Stream, TEXT("done\n"));
+		if (!Flush(true))
+		{
+			return false;
+		}
+
+		Process.CloseInput();
+
+		TArray<uint8> Output;
+		FString Errors;
+		int32 ReturnCode = -1;
+		if (!Process.RunToCompletion(Output, Errors, ReturnCode) || ReturnCode != 0)
+		{
+			UE_LOG(LogDiffHelper, Error, TEXT("git fast-import failed: %s"), *Errors);
+			return false;
+		}
+
+		// HEAD points to main, which fast-import doesn't check out
+		return RunGit(InGitBinaryPath, InDirectory, FString::Printf(TEXT("symbolic-ref HEAD refs/heads/%s"), *TargetBranch))
+			&& FFileHelper::SaveStringToFile(InParams.GetName(), *FPaths::Combine(InDirectory, GeneratedMarker));
+	}
+
+	template <typename FunctionType>
+	void Measure(const TCHAR* InName, const int32 InIterations, FunctionType&& InFunction, TArray<FBenchmarkResult>& OutResults)
+	{
+		auto& Result = OutResults.AddDefaulted_GetRef();
+		Result.Name = InName;
+		Result.Iterations = InIterations;
+		Result.MinSeconds = TNumericLimits<double>::Max();
+
+		double TotalSeconds = 0.0;
+		for (int32 Iteration = 0; Iteration < InIterations; Iteration++)
+		{
+			const double StartTime = FPlatformTime::Seconds();
+			Result.ResultCount = InFunction(Iteration);
+			const double Seconds = FPlatformTime::Seconds() - StartTime;
+
+			Result.MinSeconds = FMath::Min(Result.MinSeconds, Seconds);
+			Result.MaxSeconds = FMath::Max(Result.MaxSeconds, Seconds);
+			TotalSeconds += Seconds;
+		}
+
+		Result.AverageSeconds = InIterations > 0 ? TotalSeconds / InIterations : 0.0;
+
+		UE_LOG(LogDiffHelper, Display, TEXT("%s: min %.4f s, avg %.4f s, max %.4f s (%d results)"), InName, Result.MinSeconds, Result.AverageSeconds, Result.MaxSeconds, Result.ResultCount);
+	}
+
+	int32 CountNodes(const TArray<TSharedPtr<FDiffHelperItemNode>>& InNodes)
+	{
+		int32 NodeCount = InNodes.Num();
+		for (const auto& Node : InNodes)
+		{
+			NodeCount += CountNodes(Node->Children);
+		}
+
+		return NodeCount;
+	}
+
+	TArray<FBenchmarkResult> RunBenchmarks(const FString& InGitBinaryPath, const FString& InDirectory, const FRepositoryParams& InParams)
+	{
+		TArray<FBenchmarkResult> Results;
+
+		// Cached diffs and a commit-graph written in background would skew the timings
+		auto* Settings = GetMutableDefault<UDiffHelperSettings>();
+		const bool bEnableDiffCache = Settings->bEnableDiffCache;
+		const bool bWriteCommitGraph = Settings->bWriteCommitGraph;
+		Settings->bEnableDiffCache = false;
+		Settings->bWriteCommitGraph = false;
+
+		auto* Manager = NewObject<UDiffHelperGitManager>();
+		Manager->SetRepositoryOverride(InDirectory, InGitBinaryPath);
+
+		ON_SCOPE_EXIT
+		{
+			Manager->Deinit();
+			Settings->bEnableDiffCache = bEnableDiffCache;
+			Settings->bWriteCommitGraph = bWriteCommitGraph;
+		};
+
+		if (!Manager->Init())
+		{
+			UE_LOG(LogDiffHelper, Error, TEXT("Failed to initialize git manager for %s"), *InDirectory);
+			return Results;
+		}
+
+		const int32 Iterations = InParams.Iterations;
+
+		Measure(TEXT("GetBranches"), Iterations, [Manager](int32)
+		{
+			return Manager->GetBranches().Num();
+		}, Results);
+
+		Measure(TEXT("GetDiffCommitsList"), Iterations, [Manager](int32)
+		{
+			return Manager->GetDiffCommitsList(SourceBranch, TargetBranch).Num();
+		}, Results);
+
+		TArray<FDiffHelperDiffItem> Diff;
+		Measure(TEXT("GetDiff"), Iterations, [Manager, &Diff](int32)
+		{
+			Diff = Manager->GetDiff(SourceBranch, TargetBranch);
+			return Diff.Num();
+		}, Results);
+
+		TArray<FString> Paths;
+		Paths.Reserve(Diff.Num());
+		for (const auto& Item : Diff)
+		{
+			Paths.Add(Item.Path);
+		}
+
+		Measure(TEXT("GetLastCommitForFiles"), Iterations, [Manager, &Paths](int32)
+		{
+			return Manager->GetLastCommitForFiles(Paths, TargetBranch).Num();
+		}, Results);
+
+		Measure(TEXT("GenerateTree"), Iterations, [&Diff](int32)
+		{
+			return CountNodes(UDiffHelperUtils::GenerateTree(Diff));
+		}, Results);
+
+		auto List = UDiffHelperUtils::GenerateList(Diff);
+		auto Tree = UDiffHelperUtils::ConvertListToTree(List);
+
+		// Sort mode alternates, so every iteration reorders the nodes
+		Measure(TEXT("Sort"), Iterations, [&List, &Tree](const int32 InIteration)
+		{
+			const auto SortMode = InIteration % 2 == 0 ? EColumnSortMode::Descending : EColumnSortMode::Ascending;
+			UDiffHelperUtils::SortDiffList(SortMode, List);
+			UDiffHelperUtils::SortDiffTree(SortMode, Tree);
+			return List.Num();
+		}, Results);
+
+		const auto Filter = MakeShared<TTextFilter<const FDiffHelperDiffItem&>>(TTextFilter<const FDiffHelperDiffItem&>::FItemToStringArray::CreateLambda([](const FDiffHelperDiffItem& InItem, TArray<FString>& OutStrings)
+		{
+			OutStrings.Add(InItem.Path);
+		}));
+		Filter->SetRawFilterText(FText::FromString(TEXT("Asset1")));
+
+		Measure(TEXT("Filter"), Iterations, [&Filter, &List, &Tree](int32)
+		{
+			TArray<TSharedPtr<FDiffHelperItemNode>> Passed;
+			UDiffHelperUtils::ApplyFilter(Filter, List, Passed);
+			UDiffHelperUtils::UpdateTreeVisibility(Tree);
+			return Passed.Num();
+		}, Results);
+
+		return Results;
+	}
+
+	void SaveResults(const FRepositoryParams& InParams, const TArray<FBenchmarkResult>& InResults)
+	{
+		const auto PluginVersion = GetPluginVersion();
+		const auto EngineVersion = FEngineVersion::Current().ToString();
+		const auto Timestamp = FDateTime::UtcNow();
+		const auto BaseFilename = FPaths::Combine(GetBenchmarksDirectory(), FString::Printf(TEXT("%s_%s"), *InParams.GetName(), *Timestamp.ToString()));
+
+		FString Csv = TEXT("PluginVersion,EngineVersion,Repository,Name,Iterations,MinSeconds,AverageSeconds,MaxSeconds,ResultCount\n");
+		for (const auto& Result : InResults)
+		{
+			Csv += FString::Printf(TEXT("%s,%s,%s,%s,%d,%.6f,%.6f,%.6f,%d\n"), *PluginVersion, *EngineVersion, *InParams.GetName(), *Result.Name,
+				Result.Iterations, Result.MinSeconds, Result.AverageSeconds, Result.MaxSeconds, Result.ResultCount);
+		}
+
+		const auto Repository = MakeShared<FJsonObject>();
+		Repository->SetNumberField(TEXT("CommitCount"), InParams.CommitCount);
+		Repository->SetNumberField(TEXT("FileCount"), InParams.FileCount);
+		Repository->SetNumberField(TEXT("FanOut"), InParams.FanOut);
+		Repository->SetNumberField(TEXT("BlobSize"), InParams.BlobSize);
+		Repository->SetNumberField(TEXT("FilesPerCommit"), InParams.FilesPerCommit);
+
+		TArray<TSharedPtr<FJsonValue>> JsonResults;
+		for (const auto& Result : InResults)
+		{
+			const auto JsonResult = MakeShared<FJsonObject>();
+			JsonResult->SetStringField(TEXT("Name"), Result.Name);
+			JsonResult->SetNumberField(TEXT("Iterations"), Result.Iterations);
+			JsonResult->SetNumberField(TEXT("MinSeconds"), Result.MinSeconds);
+			JsonResult->SetNumberField(TEXT("AverageSeconds"), Result.AverageSeconds);
+			JsonResult->SetNumberField(TEXT("MaxSeconds"), Result.MaxSeconds);
+			JsonResult->SetNumberField(TEXT("ResultCount"), Result.ResultCount);
+			JsonResults.Add(MakeShared<FJsonValueObject>(JsonResult));
+		}
+
+		const auto Root = MakeShared<FJsonObject>();
+		Root->SetStringField(TEXT("PluginVersion"), PluginVersion);
+		Root->SetStringField(TEXT("EngineVersion"), EngineVersion);
+		Root->SetStringField(TEXT("Timestamp"), Timestamp.ToIso8601());
+		Root->SetObjectField(TEXT("Repository"), Repository);
+		Root->SetArrayField(TEXT("Results"), JsonResults);
+
+		FString Json;
+		const auto Writer = TJsonWriterFactory<>::Create(&Json);
+		FJsonSerializer::Serialize(Root, Writer);
+
+		const auto CsvFilename = BaseFilename + TEXT(".csv");
+		const auto JsonFilename = BaseFilename + TEXT(".json");
+		if (FFileHelper::SaveStringToFile(Csv, *CsvFilename) && FFileHelper::SaveStringToFile(Json, *JsonFilename))
+		{
+			UE_LOG(LogDiffHelper, Display, TEXT("Benchmark results saved to %s and %s"), *CsvFilename, *JsonFilename);
+		}
+		else
+		{
+			UE_LOG(LogDiffHelper, Error, TEXT("Failed to save benchmark results to %s"), *GetBenchmarksDirectory());
+		}
+	}
+
+	void RunRepositoryBenchmark(const TArray<FString>& InArgs)
+	{
+		FRepositoryParams Params;
+		int32* const ParamValues[] = {&Params.CommitCount, &Params.FileCount, &Params.FanOut, &Params.BlobSize, &Params.Iterations};
+		const int32 ParamCount = UE_ARRAY_COUNT(ParamValues);
+		for (int32 Index = 0; Index < InArgs.Num() && Index < ParamCount; Index++)
+		{
+			*ParamValues[Index] = FCString::Atoi(*InArgs[Index]);
+		}
+
+		if (Params.CommitCount < 2 || Params.FileCount <= 0 || Params.FanOut <= 0 || Params.BlobSize <= 0 || Params.Iterations <= 0)
+		{
+			UE_LOG(LogDiffHelper, Error, TEXT("Usage: DiffHelper.Benchmark.Repository [CommitCount>=2] [FileCount] [FanOut] [BlobSize] [Iterations]"));
+			return;
+		}
+
+		const auto GitBinaryPath = FindGitBinary();
+		if (GitBinaryPath.IsEmpty())
+		{
+			UE_LOG(LogDiffHelper, Error, TEXT("Git binary wasn't found, set it up in Revision Control settings"));
+			return;
+		}
+
+		// Repositories are kept between runs, generating a big one takes much longer than benchmarking it
+		const auto Directory = FPaths::ConvertRelativePathToFull(FPaths::Combine(GetBenchmarksDirectory(), TEXT("Repositories"), Params.GetName()));
+		if (!FPaths::FileExists(FPaths::Combine(Directory, GeneratedMarker)))
+		{
+			UE_LOG(LogDiffHelper, Display, TEXT("Generating repository %s"), *Directory);
+
+			const double StartTime = FPlatformTime::Seconds();
+			if (!GenerateRepository(GitBinaryPath, Directory, Params))
+			{
+				UE_LOG(LogDiffHelper, Error, TEXT("Failed to generate repository %s"), *Directory);
+				return;
+			}
+
+			UE_LOG(LogDiffHelper, Display, TEXT("Repository generated in %.1f s"), FPlatformTime::Seconds() - StartTime);
+		}
+
+		UE_LOG(LogDiffHelper, Display, TEXT("Repository benchmark %s, plugin %s, %d iterations"), *Params.GetName(), *GetPluginVersion(), Params.Iterations);
+
+		const auto Results = RunBenchmarks(GitBinaryPath, Directory, Params);
+		if (Results.Num() > 0)
+		{
+			SaveResults(Params, Results);
+		}
+	}
+
+	FAutoConsoleCommand RepositoryBenchmarkCommand(
+		TEXT("DiffHelper.Benchmark.Repository"),
+		TEXT("Generates a git repository in Saved/DiffHelper/Benchmarks and measures git manager queries, tree building, sorting and filtering on it. ")
+		TEXT("Results are written there as CSV and JSON. Usage: DiffHelper.Benchmark.Repository [CommitCount] [FileCount] [FanOut] [BlobSize] [Iterations]"),
+		FConsoleCommandWithArgsDelegate::CreateStatic(&RunRepositoryBenchmark));
+}
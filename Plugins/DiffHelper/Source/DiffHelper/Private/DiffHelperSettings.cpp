@@ -1,6 +1,32 @@
 ﻿// Copyright 2024 Gradess Games. All Rights Reserved.
 
 #include "DiffHelperSettings.h"
+#include "Misc/ScopeRWLock.h"
+
+FRegexPattern UDiffHelperSettings::GetRegexPattern(const FString& InPattern) const
+{
+	{
+		FReadScopeLock ReadLock(RegexPatternsLock);
+
+		// FString comparison is case-insensitive by default, which is wrong for patterns like \s and \S
+		const auto* Cached = RegexPatterns.Find(&InPattern);
+		if (Cached && Cached->Source.Equals(InPattern, ESearchCase::CaseSensitive))
+		{
+			return Cached->Pattern;
+		}
+	}
+
+	SCOPED_NAMED_EVENT(UDiffHelperSettings_CompileRegexPattern, FColor::Red);
+
+	FWriteScopeLock WriteLock(RegexPatternsLock);
+	return RegexPatterns.Emplace(&InPattern, FCachedRegexPattern(InPattern)).Pattern;
+}
+
+void UDiffHelperSettings::ResetRegexPatterns() const
+{
+	FWriteScopeLock WriteLock(RegexPatternsLock);
+	RegexPatterns.Reset();
+}
 
 void UDiffHelperSettings::PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent)
 {
@@ -31,5 +57,7 @@ void UDiffHelperSettings::PostEditChangeProperty(FPropertyChangedEvent& Property
 		}
 	}
 
+	ResetRegexPatterns();
+
 	UObject::PostEditChangeProperty(PropertyChangedEvent);
 }
@@ -0,0 +1,178 @@
+﻿// Copyright 2024 Gradess Games. All Rights Reserved.
+
+
+#include "DiffHelperStats.h"
+#include "DiffHelperTypes.h"
+#include "HAL/IConsoleManager.h"
+#include "ProfilingDebugging/CountersTrace.h"
+
+UE_TRACE_CHANNEL_DEFINE(DiffHelperChannel);
+
+TRACE_DECLARE_INT_COUNTER(DiffHelper_GitProcesses, TEXT("DiffHelper/GitProcesses"));
+TRACE_DECLARE_MEMORY_COUNTER(DiffHelper_GitBytesRead, TEXT("DiffHelper/GitBytesRead"));
+TRACE_DECLARE_INT_COUNTER(DiffHelper_DiffCacheHits, TEXT("DiffHelper/DiffCacheHits"));
+TRACE_DECLARE_INT_COUNTER(DiffHelper_DiffCacheMisses, TEXT("DiffHelper/DiffCacheMisses"));
+TRACE_DECLARE_INT_COUNTER(DiffHelper_BlobCacheHits, TEXT("DiffHelper/BlobCacheHits"));
+TRACE_DECLARE_INT_COUNTER(DiffHelper_BlobCacheMisses, TEXT("DiffHelper/BlobCacheMisses"));
+TRACE_DECLARE_FLOAT_COUNTER(DiffHelper_LogParseTime, TEXT("DiffHelper/LogParseTime"));
+TRACE_DECLARE_FLOAT_COUNTER(DiffHelper_StatusParseTime, TEXT("DiffHelper/StatusParseTime"));
+TRACE_DECLARE_FLOAT_COUNTER(DiffHelper_DiffTime, TEXT("DiffHelper/DiffTime"));
+TRACE_DECLARE_INT_COUNTER(DiffHelper_TreeNodes, TEXT("DiffHelper/TreeNodes"));
+TRACE_DECLARE_FLOAT_COUNTER(DiffHelper_FilterLatency, TEXT("DiffHelper/FilterLatency"));
+
+namespace DiffHelperStats
+{
+	constexpr int32 DefaultDumpCount = 10;
+
+	double GetHitRate(const int64 InHits, const int64 InMisses)
+	{
+		const auto Total = InHits + InMisses;
+		return Total > 0 ? 100.0 * InHits / Total : 0.0;
+	}
+}
+
+FDiffHelperStats& FDiffHelperStats::Get()
+{
+	static FDiffHelperStats Stats;
+	return Stats;
+}
+
+void FDiffHelperStats::RecordGitProcess()
+{
+	TRACE_COUNTER_SET(DiffHelper_GitProcesses, GitProcessCount.Increment());
+}
+
+void FDiffHelperStats::RecordBytesRead(const int64 InBytes)
+{
+	if (InBytes <= 0) { return; }
+
+	TRACE_COUNTER_SET(DiffHelper_GitBytesRead, BytesRead.Add(InBytes) + InBytes);
+}
+
+void FDiffHelperStats::RecordDiffCache(const bool bInHit)
+{
+	if (bInHit)
+	{
+		TRACE_COUNTER_SET(DiffHelper_DiffCacheHits, DiffCacheHits.Increment());
+	}
+	else
+	{
+		TRACE_COUNTER_SET(DiffHelper_DiffCacheMisses, DiffCacheMisses.Increment());
+	}
+}
+
+void FDiffHelperStats::RecordBlobCache(const bool bInHit)
+{
+	if (bInHit)
+	{
+		TRACE_COUNTER_SET(DiffHelper_BlobCacheHits, BlobCacheHits.Increment());
+	}
+	else
+	{
+		TRACE_COUNTER_SET(DiffHelper_BlobCacheMisses, BlobCacheMisses.Increment());
+	}
+}
+
+void FDiffHelperStats::RecordDiff(const FDiffHelperDiffStats& InStats)
+{
+	if (!InStats.bFromCache)
+	{
+		TRACE_COUNTER_SET(DiffHelper_LogParseTime, InStats.LogParseSeconds);
+		TRACE_COUNTER_SET(DiffHelper_StatusParseTime, InStats.StatusParseSeconds);
+	}
+
+	TRACE_COUNTER_SET(DiffHelper_DiffTime, InStats.TotalSeconds);
+
+	FScopeLock ScopeLock(&DiffsCriticalSection);
+
+	if (RecordedDiffs.Num() < MaxRecordedDiffs)
+	{
+		RecordedDiffs.Add(InStats);
+	}
+	else
+	{
+		RecordedDiffs[RecordedDiffCount % MaxRecordedDiffs] = InStats;
+	}
+
+	RecordedDiffCount++;
+}
+
+void FDiffHelperStats::RecordTreeNodes(const int32 InNodeCount)
+{
+	check(IsInGameThread());
+
+	TreeNodeCount = InNodeCount;
+	TRACE_COUNTER_SET(DiffHelper_TreeNodes, InNodeCount);
+}
+
+void FDiffHelperStats::RecordFilter(const double InSeconds, const int32 InItemCount)
+{
+	check(IsInGameThread());
+
+	LastFilterSeconds = InSeconds;
+	MaxFilterSeconds = FMath::Max(MaxFilterSeconds, InSeconds);
+	FilterCount++;
+	TRACE_COUNTER_SET(DiffHelper_FilterLatency, InSeconds);
+
+	UE_LOG(LogDiffHelper, Verbose, TEXT("Filter applied to %d items in %.3fs"), InItemCount, InSeconds);
+}
+
+void FDiffHelperStats::Dump(const int32 InDiffCount) const
+{
+	const auto DiffHits = DiffCacheHits.GetValue();
+	const auto DiffMisses = DiffCacheMisses.GetValue();
+	const auto BlobHits = BlobCacheHits.GetValue();
+	const auto BlobMisses = BlobCacheMisses.GetValue();
+
+	UE_LOG(LogDiffHelper, Display, TEXT("Git processes: %lld, read from git: %.2f MB"), GitProcessCount.GetValue(), BytesRead.GetValue() / (1024.0 * 1024.0));
+	UE_LOG(LogDiffHelper, Display, TEXT("Diff cache: %lld hits, %lld misses (%.1f%%)"), DiffHits, DiffMisses, DiffHelperStats::GetHitRate(DiffHits, DiffMisses));
+	UE_LOG(LogDiffHelper, Display, TEXT("Blob cache: %lld hits, %lld misses (%.1f%%)"), BlobHits, BlobMisses, DiffHelperStats::GetHitRate(BlobHits, BlobMisses));
+	UE_LOG(LogDiffHelper, Display, TEXT("Tree nodes: %d, filters: %lld, last filter %.3fs, slowest filter %.3fs"), TreeNodeCount, FilterCount, LastFilterSeconds, MaxFilterSeconds);
+
+	FScopeLock ScopeLock(&DiffsCriticalSection);
+
+	const int32 Count = FMath::Min3(InDiffCount, RecordedDiffs.Num(), RecordedDiffCount);
+	if (Count <= 0)
+	{
+		UE_LOG(LogDiffHelper, Display, TEXT("No diffs recorded"));
+		return;
+	}
+
+	UE_LOG(LogDiffHelper, Display, TEXT("Last %d diffs, newest first:"), Count);
+
+	double TotalSeconds = 0.0;
+	for (int32 Offset = 1; Offset <= Count; Offset++)
+	{
+		const auto& Stats = RecordedDiffs[(RecordedDiffCount - Offset) % MaxRecordedDiffs];
+		TotalSeconds += Stats.TotalSeconds;
+
+		if (Stats.bFromCache)
+		{
+			UE_LOG(LogDiffHelper, Display, TEXT("  %s: %.3fs from cache, %d files"), *Stats.Range, Stats.TotalSeconds, Stats.FileCount);
+		}
+		else
+		{
+			UE_LOG(LogDiffHelper, Display, TEXT("  %s: %.3fs, log %.3fs (parse %.3fs), diff %.3fs (parse %.3fs), last commits %.3fs, %d files, %d commits"),
+				*Stats.Range, Stats.TotalSeconds,
+				Stats.LogSeconds, Stats.LogParseSeconds,
+				Stats.StatusSeconds, Stats.StatusParseSeconds,
+				Stats.LastCommitsSeconds, Stats.FileCount, Stats.CommitCount);
+		}
+	}
+
+	UE_LOG(LogDiffHelper, Display, TEXT("Average diff time: %.3fs"), TotalSeconds / Count);
+}
+
+namespace DiffHelperStats
+{
+	void DumpStats(const TArray<FString>& InArgs)
+	{
+		const int32 DiffCount = InArgs.Num() > 0 ? FCString::Atoi(*InArgs[0]) : DefaultDumpCount;
+		FDiffHelperStats::Get().Dump(FMath::Max(1, DiffCount));
+	}
+
+	FAutoConsoleCommand StatsCommand(
+		TEXT("DiffHelper.Stats"),
+		TEXT("Logs git process, cache, tree and filter counters and timings of the last diffs. Usage: DiffHelper.Stats [DiffCount]"),
+		FConsoleCommandWithArgsDelegate::CreateStatic(&DumpStats));
+}
@@ -3,4 +3,22 @@
 
 #include "DiffHelperTypes.h"
 
-DEFINE_LOG_CATEGORY(LogDiffHelper);
\ No newline at end of file
+DEFINE_LOG_CATEGORY(LogDiffHelper);
+
+FArchive& operator<<(FArchive& Ar, FDiffHelperFileData& InFileData)
+{
+	Ar << InFileData.Path;
+	Ar << reinterpret_cast<uint8&>(InFileData.Status);
+	return Ar;
+}
+
+FArchive& operator<<(FArchive& Ar, FDiffHelperCommit& InCommit)
+{
+	Ar << InCommit.Revision;
+	Ar << InCommit.Message;
+	Ar << InCommit.Author;
+	Ar << InCommit.Date;
+	Ar << InCommit.Files;
+	Ar << InCommit.HistoryIndex;
+	return Ar;
+}
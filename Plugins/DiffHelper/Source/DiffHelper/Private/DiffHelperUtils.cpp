@@ -6,13 +6,144 @@
 #include "DiffHelperManager.h"
 #include "DiffHelperSettings.h"
 #include "DiffHelperTypes.h"
+#include "Async/Async.h"
+#include "AssetRegistry/ARFilter.h"
+#include "AssetRegistry/IAssetRegistry.h"
 
+#include "Containers/StringView.h"
 #include "Framework/Notifications/NotificationManager.h"
 #include "Misc/ComparisonUtility.h"
+#include "Misc/ScopeExit.h"
 #include "Widgets/Notifications/SNotificationList.h"
 
 #define LOCTEXT_NAMESPACE "DiffHelper"
 
+namespace DiffHelperUtils
+{
+	// Git paths are case-sensitive, so the lookup is case-sensitive as well
+	struct FPathKeyFuncs : TDefaultMapKeyFuncs<FStringView, TSharedPtr<FDiffHelperItemNode>, false>
+	{
+		static FORCEINLINE bool Matches(const FStringView& A, const FStringView& B)
+		{
+			return A.Equals(B, ESearchCase::CaseSensitive);
+		}
+
+		static FORCEINLINE uint32 GetKeyHash(const FStringView& Key)
+		{
+			return FCrc::MemCrc32(Key.GetData(), Key.Len() * sizeof(TCHAR));
+		}
+	};
+
+	struct FTreeBuilder
+	{
+		TSharedPtr<FDiffHelperItemNode> Root = MakeShared<FDiffHelperItemNode>();
+
+		// Keys point into Path of the created nodes, so directory prefixes are looked up without building new strings
+		TMap<FStringView, TSharedPtr<FDiffHelperItemNode>, FDefaultSetAllocator, FPathKeyFuncs> Nodes;
+
+		explicit FTreeBuilder(const int32 InExpectedCount)
+		{
+			Nodes.Reserve(InExpectedCount);
+		}
+
+		// Finds or creates all directories of InPath, returns the last one and the start of the file name
+		TSharedPtr<FDiffHelperItemNode> AddDirectories(const FStringView& InPath, int32& OutNameStart)
+		{
+			TSharedPtr<FDiffHelperItemNode> CurrentNode = Root;
+
+			int32 ComponentStart = 0;
+			for (int32 Index = 0; Index < InPath.Len(); Index++)
+			{
+				if (InPath[Index] != TEXT('/'))
+				{
+					continue;
+				}
+
+				if (Index > ComponentStart)
+				{
+					CurrentNode = FindOrAddChild(CurrentNode, InPath, ComponentStart, Index);
+				}
+
+				ComponentStart = Index + 1;
+			}
+
+			OutNameStart = ComponentStart;
+			return CurrentNode;
+		}
+
+		TSharedPtr<FDiffHelperItemNode> FindOrAddChild(const TSharedPtr<FDiffHelperItemNode>& InParent, const FStringView& InPath, const int32 InStart, const int32 InEnd)
+		{
+			const auto Prefix = InPath.Left(InEnd);
+			if (const auto* ExistingNode = Nodes.Find(Prefix))
+			{
+				return *ExistingNode;
+			}
+
+			const auto Name = InPath.Mid(InStart, InEnd - InStart);
+
+			auto NodeChild = MakeShared<FDiffHelperItemNode>();
+			NodeChild->Path = FString(Prefix.Len(), Prefix.GetData());
+			NodeChild->Name = FString(Name.Len(), Name.GetData());
+			SetParent(NodeChild, InParent);
+			InParent->Children.Add(NodeChild);
+
+			Nodes.Add(NodeChild->Path, NodeChild);
+			return NodeChild;
+		}
+
+		// Root is dropped once the tree is built, so top level nodes don't point to it
+		void SetParent(const TSharedPtr<FDiffHelperItemNode>& InNode, const TSharedPtr<FDiffHelperItemNode>& InParent) const
+		{
+			InNode->Parent = InParent != Root ? InParent : nullptr;
+		}
+	};
+
+	// Directory of InPath from the index, missing parents are created on the way up
+	TSharedPtr<FDiffHelperItemNode> FindOrAddDirectory(const FStringView& InPath, TArray<TSharedPtr<FDiffHelperItemNode>>& InOutRoots, TMap<FString, TSharedPtr<FDiffHelperItemNode>>& InOutNodesByPath)
+	{
+		int32 SeparatorIndex = INDEX_NONE;
+		if (!InPath.FindLastChar(TEXT('/'), SeparatorIndex) || SeparatorIndex == 0)
+		{
+			return nullptr;
+		}
+
+		const auto DirectoryPath = InPath.Left(SeparatorIndex);
+		FString DirectoryKey(DirectoryPath.Len(), DirectoryPath.GetData());
+		if (const auto* ExistingNode = InOutNodesByPath.Find(DirectoryKey))
+		{
+			return *ExistingNode;
+		}
+
+		const auto Parent = FindOrAddDirectory(DirectoryPath, InOutRoots, InOutNodesByPath);
+
+		auto Directory = MakeShared<FDiffHelperItemNode>();
+		Directory->Path = MoveTemp(DirectoryKey);
+		Directory->Name = FPaths::GetCleanFilename(Directory->Path);
+		Directory->Parent = Parent;
+
+		// Becomes visible once a visible leaf is counted in it
+		Directory->bVisible = false;
+
+		(Parent.IsValid() ? Parent->Children : InOutRoots).Add(Directory);
+		InOutNodesByPath.Add(Directory->Path, Directory);
+		return Directory;
+	}
+
+	// Characters with a special meaning in TTextFilter syntax
+	bool IsPlainFilterTerm(const FString& InQuery)
+	{
+		for (const auto Char : InQuery)
+		{
+			if (FChar::IsWhitespace(Char) || FCString::Strchr(TEXT("\"'!-+|&()=<>:,"), Char) != nullptr)
+			{
+				return false;
+			}
+		}
+
+		return true;
+	}
+}
+
 TArray<FString> UDiffHelperUtils::ConvertBranchesToStringArray(const TArray<FDiffHelperBranch>& InBranches)
 {
 	TArray<FString> OutArray;
@@ -30,6 +161,26 @@ bool UDiffHelperUtils::CompareStatus(const EDiffHelperFileStatus InStatusA, cons
 	return static_cast<uint8>(InStatusA) < static_cast<uint8>(InStatusB);
 }
 
+FDiffHelperCommit UDiffHelperUtils::GetLastTargetCommit(const FDiffHelperDiffItem& InItem)
+{
+	return InItem.LastTargetCommit.IsValid() ? *InItem.LastTargetCommit : FDiffHelperCommit();
+}
+
+TArray<FDiffHelperCommit> UDiffHelperUtils::GetCommits(const FDiffHelperDiffItem& InItem)
+{
+	TArray<FDiffHelperCommit> OutArray;
+	OutArray.Reserve(InItem.Commits.Num());
+	for (const auto& Commit : InItem.Commits)
+	{
+		if (Commit.IsValid())
+		{
+			OutArray.Add(*Commit);
+		}
+	}
+
+	return OutArray;
+}
+
 bool UDiffHelperUtils::IsDiffAvailable(const TSharedPtr<FDiffHelperCommit>& InCommit, const FString& InPath)
 {
 	if (!InCommit.IsValid())
@@ -68,6 +219,74 @@ bool UDiffHelperUtils::IsUnrealAsset(const FString& InPackageName)
 	return PackageExtension != EPackageExtension::Custom && PackageExtension != EPackageExtension::Unspecified;
 }
 
+FName UDiffHelperUtils::GetAssetPackageName(const FString& InPath)
+{
+	const auto RelativePath = FPaths::Combine(FPaths::ProjectDir(), InPath);
+	if (!FPaths::IsUnderDirectory(RelativePath, FPaths::ProjectContentDir()) || !IsUnrealAsset(RelativePath))
+	{
+		return NAME_None;
+	}
+
+	FString PackageName;
+	if (!FPackageName::TryConvertFilenameToLongPackageName(RelativePath, PackageName))
+	{
+		return NAME_None;
+	}
+
+	return FName(PackageName);
+}
+
+void UDiffHelperUtils::ResolveAssetData(const TArrayView<FDiffHelperDiffItem>& InOutItems)
+{
+	SCOPED_NAMED_EVENT(UDiffHelperUtils_ResolveAssetData, FColor::Red);
+
+	auto* AssetRegistry = IAssetRegistry::Get();
+	if (!AssetRegistry)
+	{
+		return;
+	}
+
+	// In-memory assets can be enumerated only on the game thread, files of a diff are read from disk anyway
+	FARFilter Filter;
+	Filter.bIncludeOnlyOnDiskAssets = true;
+
+	TMap<FName, int32> ItemIndices;
+	ItemIndices.Reserve(InOutItems.Num());
+	for (int32 ItemIndex = 0; ItemIndex < InOutItems.Num(); ItemIndex++)
+	{
+		const auto PackageName = GetAssetPackageName(InOutItems[ItemIndex].Path);
+		if (!PackageName.IsNone())
+		{
+			Filter.PackageNames.Add(PackageName);
+			ItemIndices.Add(PackageName, ItemIndex);
+		}
+	}
+
+	if (Filter.PackageNames.Num() == 0)
+	{
+		return;
+	}
+
+	TArray<FAssetData> Assets;
+	AssetRegistry->GetAssets(Filter, Assets);
+
+	for (auto& Asset : Assets)
+	{
+		const auto* ItemIndex = ItemIndices.Find(Asset.PackageName);
+		if (!ItemIndex)
+		{
+			continue;
+		}
+
+		// Package could contain several assets, the main one is named after the package
+		auto& AssetData = InOutItems[*ItemIndex].AssetData;
+		if (!AssetData.IsValid() || Asset.AssetName == FPackageName::GetShortFName(Asset.PackageName))
+		{
+			AssetData = MoveTemp(Asset);
+		}
+	}
+}
+
 int32 UDiffHelperUtils::GetItemNodeFilesCount(const TSharedPtr<FDiffHelperItemNode>& InItem)
 {
 	const auto& Children = InItem->Children;
@@ -112,44 +331,37 @@ TArray<TSharedPtr<FDiffHelperItemNode>> UDiffHelperUtils::GenerateTree(const TAr
 
 TSharedPtr<FDiffHelperItemNode> UDiffHelperUtils::PopulateTree(const TArray<TSharedPtr<FDiffHelperDiffItem>>& InItems)
 {
-	auto Root = MakeShared<FDiffHelperItemNode>();
+	SCOPED_NAMED_EVENT(UDiffHelperUtils_PopulateTree, FColor::Red);
+
+	DiffHelperUtils::FTreeBuilder Builder(InItems.Num());
 	for (const auto& Item : InItems)
 	{
-		TArray<FString> PathComponents;
-		Item->Path.ParseIntoArray(PathComponents, TEXT("/"), true);
+		const FStringView ItemPath = Item->Path;
 
-		TSharedPtr<FDiffHelperItemNode> CurrentNode = Root;
-		FString CurrentPath = "";
+		int32 NameStart = 0;
+		const auto Parent = Builder.AddDirectories(ItemPath, NameStart);
 
-		for (const auto& PathComponent : PathComponents)
-		{
-			CurrentPath = FPaths::Combine(CurrentPath, PathComponent);
-
-			TSharedPtr<FDiffHelperItemNode> NodeChild;
-			for (const auto& ExistingNodeChild : CurrentNode->Children)
-			{
-				if (ExistingNodeChild->Path == CurrentPath)
-				{
-					NodeChild = ExistingNodeChild;
-					break;
-				}
-			}
+		const auto Node = NameStart < ItemPath.Len() ? Builder.FindOrAddChild(Parent, ItemPath, NameStart, ItemPath.Len()) : Parent;
+		Node->DiffItem = Item;
+	}
 
-			if (!NodeChild.IsValid())
-			{
-				NodeChild = MakeShared<FDiffHelperItemNode>();
-				NodeChild->Path = CurrentPath;
-				NodeChild->Name = PathComponent;
-				CurrentNode->Children.Add(NodeChild);
-			}
+	return Builder.Root;
+}
 
-			CurrentNode = NodeChild;
-		}
+TSharedPtr<FDiffHelperItemNode> UDiffHelperUtils::PopulateTree(const TArray<TSharedPtr<FDiffHelperItemNode>>& InLeaves)
+{
+	SCOPED_NAMED_EVENT(UDiffHelperUtils_PopulateTreeFromLeaves, FColor::Red);
 
-		CurrentNode->DiffItem = Item;
+	DiffHelperUtils::FTreeBuilder Builder(InLeaves.Num());
+	for (const auto& Leaf : InLeaves)
+	{
+		int32 NameStart = 0;
+		const auto Parent = Builder.AddDirectories(Leaf->Path, NameStart);
+		Builder.SetParent(Leaf, Parent);
+		Parent->Children.Add(Leaf);
 	}
 
-	return Root;
+	return Builder.Root;
 }
 
 TArray<TSharedPtr<FDiffHelperItemNode>> UDiffHelperUtils::ConvertTreeToList(const TArray<TSharedPtr<FDiffHelperItemNode>>& InRoot)
@@ -172,113 +384,72 @@ TArray<TSharedPtr<FDiffHelperItemNode>> UDiffHelperUtils::ConvertTreeToList(cons
 
 TArray<TSharedPtr<FDiffHelperItemNode>> UDiffHelperUtils::ConvertListToTree(const TArray<TSharedPtr<FDiffHelperItemNode>>& InList)
 {
-	TArray<TSharedPtr<FDiffHelperDiffItem>> Items;
+	TArray<TSharedPtr<FDiffHelperItemNode>> Leaves;
+	Leaves.Reserve(InList.Num());
 
 	for (const auto& Node : InList)
 	{
 		if (ensure(Node->DiffItem.IsValid()))
 		{
-			Items.Add(Node->DiffItem);
+			Leaves.Add(Node);
 		}
 	}
 
-	return GenerateTree(Items);
+	return PopulateTree(Leaves)->Children;
 }
 
-TMap<FString, TSharedPtr<FDiffHelperItemNode>> UDiffHelperUtils::GetDirectories(const TArray<TSharedPtr<FDiffHelperItemNode>>& InItems)
+void UDiffHelperUtils::IndexTree(const TArray<TSharedPtr<FDiffHelperItemNode>>& InNodes, TMap<FString, TSharedPtr<FDiffHelperItemNode>>& OutNodesByPath)
 {
-	TMap<FString, TSharedPtr<FDiffHelperItemNode>> OutMap;
-	for (const auto& Node : InItems)
+	for (const auto& Node : InNodes)
 	{
-		if (!Node->DiffItem.IsValid() && !Node->Path.IsEmpty())
-		{
-			OutMap.Add(Node->Path, Node);
-		}
-
-		OutMap.Append(GetDirectories(Node->Children));
+		OutNodesByPath.Add(Node->Path, Node);
+		IndexTree(Node->Children, OutNodesByPath);
 	}
-
-	return OutMap;
 }
 
-TMap<FString, TSharedPtr<FDiffHelperItemNode>> UDiffHelperUtils::GetDirectories(const TArrayView<const TSharedPtr<FDiffHelperItemNode>>& InItems)
+void UDiffHelperUtils::InsertIntoTree(const TArray<TSharedPtr<FDiffHelperItemNode>>& InLeaves, TArray<TSharedPtr<FDiffHelperItemNode>>& InOutRoots, TMap<FString, TSharedPtr<FDiffHelperItemNode>>& InOutNodesByPath)
 {
-	TMap<FString, TSharedPtr<FDiffHelperItemNode>> OutMap;
-	for (const auto& Node : InItems)
-	{
-		if (!Node->DiffItem.IsValid() && !Node->Path.IsEmpty())
-		{
-			OutMap.Add(Node->Path, Node);
-		}
-
-		OutMap.Append(GetDirectories(Node->Children));
-	}
+	SCOPED_NAMED_EVENT(UDiffHelperUtils_InsertIntoTree, FColor::Red);
 
-	return OutMap;
-}
-
-TSharedPtr<FDiffHelperItemNode> UDiffHelperUtils::FindItemInTree(const TArray<TSharedPtr<FDiffHelperItemNode>>& InItems, const TSharedPtr<FDiffHelperItemNode>& InItem)
-{
-	if (!InItem.IsValid())
-	{
-		return nullptr;
-	}
-	
-	return FindItemInTree(InItems, InItem->Path);
-}
-
-TSharedPtr<FDiffHelperItemNode> UDiffHelperUtils::FindItemInTree(const TArray<TSharedPtr<FDiffHelperItemNode>>& InItems, const FString& InPath)
-{
-	if (InPath.IsEmpty())
-	{
-		return nullptr;
-	}
-
-	TQueue<TSharedPtr<FDiffHelperItemNode>> Queue;
-
-	auto EnqueueArray = [&Queue](const TArray<TSharedPtr<FDiffHelperItemNode>>& InArray)
-	{
-		for (const auto& Node : InArray)
-		{
-			Queue.Enqueue(Node);
-		}
-	};
-	EnqueueArray(InItems);
-	
-	while (!Queue.IsEmpty())
+	InOutNodesByPath.Reserve(InOutNodesByPath.Num() + InLeaves.Num());
+	for (const auto& Leaf : InLeaves)
 	{
-		TSharedPtr<FDiffHelperItemNode> Node;
-		Queue.Dequeue(Node);
-		if (Node->Path.Equals(InPath))
-		{
-			return Node;
-		}
+		const auto Parent = DiffHelperUtils::FindOrAddDirectory(Leaf->Path, InOutRoots, InOutNodesByPath);
+		Leaf->Parent = Parent;
 
-		EnqueueArray(Node->Children);
+		(Parent.IsValid() ? Parent->Children : InOutRoots).Add(Leaf);
+		InOutNodesByPath.Add(Leaf->Path, Leaf);
 	}
-
-	return nullptr;
 }
 
 void UDiffHelperUtils::CopyExpandedState(const TArray<TSharedPtr<FDiffHelperItemNode>>& InSource, TArray<TSharedPtr<FDiffHelperItemNode>>& InTarget)
 {
-	for (const auto& TargetNode : InTarget)
+	TSet<FString> ExpandedPaths;
+	TFunction<void(const TArray<TSharedPtr<FDiffHelperItemNode>>&)> CollectExpanded = [&](const TArray<TSharedPtr<FDiffHelperItemNode>>& InNodes)
 	{
-		if (TargetNode->DiffItem.IsValid())
+		for (const auto& Node : InNodes)
 		{
-			continue;
+			if (Node->bExpanded && !Node->DiffItem.IsValid())
+			{
+				ExpandedPaths.Add(Node->Path);
+				CollectExpanded(Node->Children);
+			}
 		}
+	};
+	CollectExpanded(InSource);
 
-		for (const auto& SourceNode : InSource)
+	TFunction<void(const TArray<TSharedPtr<FDiffHelperItemNode>>&)> ApplyExpanded = [&](const TArray<TSharedPtr<FDiffHelperItemNode>>& InNodes)
+	{
+		for (const auto& Node : InNodes)
 		{
-			if (SourceNode->Path == TargetNode->Path)
+			if (!Node->DiffItem.IsValid() && ExpandedPaths.Contains(Node->Path))
 			{
-				TargetNode->bExpanded = SourceNode->bExpanded;
-				CopyExpandedState(SourceNode->Children, TargetNode->Children);
-				break;
+				Node->bExpanded = true;
+				ApplyExpanded(Node->Children);
 			}
 		}
-	}
+	};
+	ApplyExpanded(InTarget);
 }
 
 void UDiffHelperUtils::SortDiffList(const EColumnSortMode::Type InSortMode, TArray<TSharedPtr<FDiffHelperItemNode>>& OutArray)
@@ -365,6 +536,84 @@ void UDiffHelperUtils::Filter(TSharedPtr<IFilter<const FDiffHelperDiffItem&>> In
 	});
 }
 
+void UDiffHelperUtils::ApplyFilter(const TSharedPtr<IFilter<const FDiffHelperDiffItem&>>& InFilter, const TArray<TSharedPtr<FDiffHelperItemNode>>& InCandidates, TArray<TSharedPtr<FDiffHelperItemNode>>& OutPassed)
+{
+	SCOPED_NAMED_EVENT(UDiffHelperUtils_ApplyFilter, FColor::Red);
+
+	OutPassed.Reset(InCandidates.Num());
+	for (const auto& Node : InCandidates)
+	{
+		Node->bVisible = !Node->DiffItem.IsValid() || !InFilter.IsValid() || InFilter->PassesFilter(*Node->DiffItem);
+		if (Node->bVisible)
+		{
+			OutPassed.Add(Node);
+		}
+	}
+}
+
+int32 UDiffHelperUtils::UpdateTreeVisibility(const TArray<TSharedPtr<FDiffHelperItemNode>>& InNodes)
+{
+	int32 VisibleFilesCount = 0;
+	for (const auto& Node : InNodes)
+	{
+		if (Node->DiffItem.IsValid())
+		{
+			VisibleFilesCount += Node->bVisible ? 1 : 0;
+			continue;
+		}
+
+		Node->VisibleFilesCount = UpdateTreeVisibility(Node->Children);
+		Node->bVisible = Node->VisibleFilesCount > 0;
+		VisibleFilesCount += Node->VisibleFilesCount;
+	}
+
+	return VisibleFilesCount;
+}
+
+void UDiffHelperUtils::AddVisibleLeaves(const TArray<TSharedPtr<FDiffHelperItemNode>>& InLeaves)
+{
+	for (const auto& Leaf : InLeaves)
+	{
+		if (!Leaf->bVisible)
+		{
+			continue;
+		}
+
+		for (auto Directory = Leaf->Parent.Pin(); Directory.IsValid(); Directory = Directory->Parent.Pin())
+		{
+			Directory->VisibleFilesCount++;
+			Directory->bVisible = true;
+		}
+	}
+}
+
+TArray<TSharedPtr<FDiffHelperItemNode>> UDiffHelperUtils::GetVisibleNodes(const TArray<TSharedPtr<FDiffHelperItemNode>>& InNodes)
+{
+	TArray<TSharedPtr<FDiffHelperItemNode>> OutArray;
+	OutArray.Reserve(InNodes.Num());
+
+	for (const auto& Node : InNodes)
+	{
+		if (Node->bVisible)
+		{
+			OutArray.Add(Node);
+		}
+	}
+
+	return OutArray;
+}
+
+bool UDiffHelperUtils::IsNarrowingQuery(const FString& InPreviousQuery, const FString& InNewQuery)
+{
+	// Only a single plain term is a substring match, so appending characters to it can only remove results
+	if (InPreviousQuery.IsEmpty() || !InNewQuery.StartsWith(InPreviousQuery, ESearchCase::IgnoreCase))
+	{
+		return false;
+	}
+
+	return DiffHelperUtils::IsPlainFilterTerm(InPreviousQuery) && DiffHelperUtils::IsPlainFilterTerm(InNewQuery);
+}
+
 void UDiffHelperUtils::ShowDiffUnavailableDialog(const TArray<TSharedPtr<FDiffHelperCommit>>& InCommits, const FString& InPath)
 {
 	for (const auto& Commit : InCommits)
@@ -454,18 +703,16 @@ void UDiffHelperUtils::CollapseAll(TArray<TSharedPtr<FDiffHelperItemNode>>& InAr
 void UDiffHelperUtils::DiffFileExternal(const FString& InPath, const FDiffHelperCommit& InLeftRevision, const FDiffHelperCommit& InRightRevision)
 {
 	// TODO: Works only for Win platform. We need to find better solution to be cross-platform.
-	const auto Manager = FDiffHelperModule::Get().GetManager();
-	const auto RightFilename = Manager->GetFile(InPath, InLeftRevision.Revision);
-	const auto LeftFilename = Manager->GetFile(InPath, InRightRevision.Revision);
-
-	if (!RightFilename.IsSet() || !LeftFilename.IsSet())
+	FString RightFilename;
+	FString LeftFilename;
+	if (!GetDiffFiles(InPath, InLeftRevision.Revision, InRightRevision.Revision, RightFilename, LeftFilename))
 	{
 		AddErrorNotification(FText::Format(LOCTEXT("DiffFileExternalError", "Failed to get diff files for path: {0}"), FText::FromString(InPath)));
 		return;
 	}
 
 	const auto& ExternalDiffCommand = GetDefault<UDiffHelperSettings>()->ExternalDiffCommand;
-	const auto Command = TEXT(" /c ") + FString::Format(*ExternalDiffCommand, {RightFilename.GetValue(), LeftFilename.GetValue(), InLeftRevision.Revision, InRightRevision.Revision});
+	const auto Command = TEXT(" /c ") + FString::Format(*ExternalDiffCommand, {RightFilename, LeftFilename, InLeftRevision.Revision, InRightRevision.Revision});
 
 	int32 Result;
 	FString StdError;
@@ -491,6 +738,42 @@ void UDiffHelperUtils::DiffFileExternal(const FString& InPath, const FDiffHelper
 	}
 }
 
+bool UDiffHelperUtils::GetDiffFiles(const FString& InPath, const FString& InLeftRevision, const FString& InRightRevision, FString& OutLeftFilename, FString& OutRightFilename)
+{
+	SCOPED_NAMED_EVENT(UDiffHelperUtils_GetDiffFiles, FColor::Red);
+
+	const auto Manager = FDiffHelperModule::Get().GetManager();
+	if (!Manager.IsValid())
+	{
+		return false;
+	}
+
+	// Counted before the task is queued, so Deinit can't finish before the task starts using the manager
+	const IDiffHelperManager* ManagerPtr = Manager.Get();
+	if (!ManagerPtr->BeginBackgroundTask())
+	{
+		return false;
+	}
+
+	auto LeftFuture = Async(EAsyncExecution::ThreadPool, [ManagerPtr, InPath, InLeftRevision]()
+	{
+		ON_SCOPE_EXIT { ManagerPtr->EndBackgroundTask(); };
+		return ManagerPtr->GetFile(InPath, InLeftRevision);
+	});
+
+	const auto RightFilename = ManagerPtr->GetFile(InPath, InRightRevision);
+	const auto LeftFilename = LeftFuture.Get();
+
+	if (!LeftFilename.IsSet() || !RightFilename.IsSet())
+	{
+		return false;
+	}
+
+	OutLeftFilename = LeftFilename.GetValue();
+	OutRightFilename = RightFilename.GetValue();
+	return true;
+}
+
 bool UDiffHelperUtils::IsValidForDiff(const FString& InPath)
 {
 	return IsUnrealAsset(InPath) || GetDefault<UDiffHelperSettings>()->bEnableExternalDiff;
@@ -9,9 +9,12 @@
 #include "DiffHelperCommands.h"
 #include "DiffHelperManager.h"
 #include "DiffHelperSettings.h"
+#include "DiffHelperStats.h"
 #include "DiffHelperUtils.h"
 #include "DiffUtils.h"
 #include "EditorAssetLibrary.h"
+#include "Algo/BinarySearch.h"
+#include "Async/Async.h"
 
 #include "UI/DiffHelperTabModel.h"
 
@@ -29,54 +32,124 @@ void UDiffHelperTabController::Init()
 
 void UDiffHelperTabController::Reset()
 {
+	CancelCollectDiff();
+	CancelFilterUpdate();
+	CancelPrefetch();
 	InitModel();
 	OnModelReset.Broadcast();
 }
 
 void UDiffHelperTabController::Deinit()
 {
+	CancelCollectDiff();
+	CancelFilterUpdate();
+	CancelPrefetch();
 	RemoveFromRoot();
 	Model = nullptr;
 }
 
 void UDiffHelperTabController::SetSourceBranch(const FDiffHelperBranch& InBranch)
 {
+	if (Model->SourceBranch != InBranch)
+	{
+		CancelCollectDiff();
+	}
+
 	Model->SourceBranch = InBranch;
 }
 
 void UDiffHelperTabController::SetTargetBranch(const FDiffHelperBranch& InBranch)
 {
+	if (Model->TargetBranch != InBranch)
+	{
+		CancelCollectDiff();
+	}
+
 	Model->TargetBranch = InBranch;
 }
 
 void UDiffHelperTabController::SelectDiffItem(const FDiffHelperDiffItem& InDiffItem)
 {
 	Model->SelectedDiffItem = InDiffItem;
+	ResolveAssetData(Model->SelectedDiffItem);
+	PrefetchDiffFiles(InDiffItem);
 }
 
 void UDiffHelperTabController::CollectDiff()
 {
+	CancelCollectDiff();
+
+	CancelFilterUpdate();
+
+	auto& Data = Model->DiffPanelData;
+	Model->Diff.Reset();
+	Model->CommitStore.Reset();
+	Model->AssetDataCache.Reset();
+	Model->SelectedDiffItem = FDiffHelperDiffItem();
+	Data.OriginalDiff.Reset();
+	Data.FilteredDiff.Reset();
+	Data.OriginalTreeDiff.Reset();
+	Data.TreeDiff.Reset();
+	Data.NodesByPath.Reset();
+	Data.AppliedFilterText.Reset();
+	Data.SelectedNode.Reset();
+
+	if (!Data.SearchFilter.IsValid())
+	{
+		Data.SearchFilter = MakeShared<TTextFilter<const FDiffHelperDiffItem&>>(TTextFilter<const FDiffHelperDiffItem&>::FItemToStringArray::CreateStatic(&UDiffHelperTabController::PopulateFilterSearchString));
+	}
+
+	// Counted before the task is queued, Deinit could otherwise finish before the task starts using the manager
 	const auto Manager = FDiffHelperModule::Get().GetManager();
-	auto Diff = Manager->GetDiff(Model->SourceBranch, Model->TargetBranch);
-	Diff.Sort([](const FDiffHelperDiffItem& A, const FDiffHelperDiffItem& B)
+	if (!Manager.IsValid() || !Manager->BeginBackgroundTask())
 	{
-#if ENGINE_MAJOR_VERSION >= 5 && ENGINE_MINOR_VERSION >= 3
-		return UE::ComparisonUtility::CompareNaturalOrder(A.Path, B.Path) < 0;
-#else
-		return A.Path.Compare(B.Path, ESearchCase::IgnoreCase) < 0;
-#endif
-	});
+		return;
+	}
 
-	Model->Diff = Diff;
+	Data.bIsLoading = true;
+	Data.LoadingStatus = LOCTEXT("LoadingDiff", "Loading diff...");
 
-	Model->DiffPanelData.OriginalDiff = UDiffHelperUtils::GenerateList(Model->Diff);
-	UDiffHelperUtils::SortDiffList(Model->DiffPanelData.SortMode, Model->DiffPanelData.OriginalDiff);
-	Model->DiffPanelData.FilteredDiff = Model->DiffPanelData.OriginalDiff;
-	
-	Model->DiffPanelData.TreeDiff = UDiffHelperUtils::GenerateTree(Model->Diff);
-	UDiffHelperUtils::SortDiffTree(Model->DiffPanelData.SortMode, Model->DiffPanelData.TreeDiff);
+	CollectDiffCancellationFlag = MakeShared<FThreadSafeBool>(false);
+
+	const IDiffHelperManager* ManagerPtr = Manager.Get();
+	const FString SourceRevision = Model->SourceBranch;
+	const FString TargetRevision = Model->TargetBranch;
+	const auto CancellationFlag = CollectDiffCancellationFlag;
+	const TWeakObjectPtr<UDiffHelperTabController> WeakThis = this;
 
-	Model->DiffPanelData.SearchFilter = MakeShared<TTextFilter<const FDiffHelperDiffItem&>>(TTextFilter<const FDiffHelperDiffItem&>::FItemToStringArray::CreateUObject(this, &UDiffHelperTabController::PopulateFilterSearchString));
+	Async(EAsyncExecution::ThreadPool, [ManagerPtr, SourceRevision, TargetRevision, CancellationFlag, WeakThis]()
+	{
+		// Results are dropped if the collection was cancelled before they reached the game thread
+		auto RunOnGameThread = [CancellationFlag, WeakThis](TUniqueFunction<void(UDiffHelperTabController*)>&& InFunction)
+		{
+			AsyncTask(ENamedThreads::GameThread, [CancellationFlag, WeakThis, Function = MoveTemp(InFunction)]()
+			{
+				if (!*CancellationFlag && WeakThis.IsValid())
+				{
+					Function(WeakThis.Get());
+				}
+			});
+		};
+
+		FDiffHelperDiffContext Context;
+		Context.CancellationFlag = CancellationFlag;
+		Context.OnStageChanged = [RunOnGameThread](const FText& InStage)
+		{
+			RunOnGameThread([InStage](UDiffHelperTabController* InController) { InController->SetLoadingStatus(InStage); });
+		};
+		Context.OnBatchReady = [RunOnGameThread](TArray<FDiffHelperDiffItem>&& InItems)
+		{
+			RunOnGameThread([Items = MoveTemp(InItems)](UDiffHelperTabController* InController) mutable { InController->AppendDiffItems(MoveTemp(Items)); });
+		};
+
+		ManagerPtr->StreamDiff(SourceRevision, TargetRevision, Context);
+		ManagerPtr->EndBackgroundTask();
+
+		RunOnGameThread([](UDiffHelperTabController* InController) { InController->FinishCollectDiff(); });
+	});
+
+	NotifyModelChanged(EDiffHelperModelChange::Diff | EDiffHelperModelChange::Selection);
+	Data.OnDiffItemsUpdated.Broadcast();
 }
 
 void UDiffHelperTabController::DiffAsset(const FString& InPath, const FDiffHelperCommit& InFirstRevision, const FDiffHelperCommit& InSecondRevision) const
@@ -94,18 +167,17 @@ void UDiffHelperTabController::DiffAsset(const FString& InPath, const FDiffHelpe
 	RightVersionInfo.Revision = InSecondRevision.Revision;
 	RightVersionInfo.Date = InSecondRevision.Date;
 
-	const auto Manager = FDiffHelperModule::Get().GetManager();
-	const auto LeftTempFilename = Manager->GetFile(InPath, InFirstRevision.Revision);
-	const auto RightTempFilename = Manager->GetFile(InPath, InSecondRevision.Revision);
-
-	if (!LeftTempFilename.IsSet() || !RightTempFilename.IsSet())
+	FString LeftTempFilename;
+	FString RightTempFilename;
+	if (!UDiffHelperUtils::GetDiffFiles(InPath, InFirstRevision.Revision, InSecondRevision.Revision, LeftTempFilename, RightTempFilename))
 	{
 		UE_LOG(LogDiffHelper, Error, TEXT("Failed to get diff file for %s"), *InPath);
 		return;
 	}
 
-	const auto LeftPackagePath = FPackagePath::FromLocalPath(LeftTempFilename.GetValue());
-	const auto RightPackagePath = FPackagePath::FromLocalPath(RightTempFilename.GetValue());
+	// Packages are loaded one by one, loading for diff is only allowed on the game thread
+	const auto LeftPackagePath = FPackagePath::FromLocalPath(LeftTempFilename);
+	const auto RightPackagePath = FPackagePath::FromLocalPath(RightTempFilename);
 	const auto OriginalPackagePath = FPackagePath::FromLocalPath(InPath);
 
 #if ENGINE_MAJOR_VERSION >= 5 && ENGINE_MINOR_VERSION >= 3
@@ -147,7 +219,13 @@ void UDiffHelperTabController::DiffAsset(const FString& InPath, const FDiffHelpe
 
 void UDiffHelperTabController::CallModelUpdated() const
 {
-	Model->OnModelUpdated_Raw.Broadcast();
+	NotifyModelChanged(EDiffHelperModelChange::All);
+}
+
+void UDiffHelperTabController::NotifyModelChanged(EDiffHelperModelChange InChange) const
+{
+	Model->OnModelChanged.Broadcast(InChange);
+	Model->OnModelUpdated.Broadcast();
 }
 
 void UDiffHelperTabController::SetSearchFilter(const FText& InText) const
@@ -155,22 +233,34 @@ void UDiffHelperTabController::SetSearchFilter(const FText& InText) const
 	Model->DiffPanelData.SearchFilter->SetRawFilterText(InText);
 }
 
+void UDiffHelperTabController::RequestFilterUpdate(const FText& InText)
+{
+	PendingSearchText = InText;
+
+	FTSTicker::GetCoreTicker().RemoveTicker(SearchDebounceHandle);
+	const auto* Settings = GetDefault<UDiffHelperSettings>();
+	SearchDebounceHandle = FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateUObject(this, &UDiffHelperTabController::DispatchFilterUpdate), Settings->SearchDebounceInterval);
+}
+
 void UDiffHelperTabController::SetSortingMode(const FName& InColumnId, EColumnSortMode::Type InSortMode) const
 {
 	auto& Data = Model->DiffPanelData;
 	Data.SortMode = InSortMode;
 
-	UDiffHelperUtils::SortDiffList(Data.SortMode, Data.FilteredDiff);
-	UDiffHelperUtils::SortDiffTree(Data.SortMode, Data.TreeDiff);
+	// Visibility doesn't depend on the order, so nodes are only reordered and never tested again
+	UDiffHelperUtils::SortDiffList(Data.SortMode, Data.OriginalDiff);
+	UDiffHelperUtils::SortDiffTree(Data.SortMode, Data.OriginalTreeDiff);
+	Data.FilteredDiff = UDiffHelperUtils::GetVisibleNodes(Data.OriginalDiff);
+	Data.TreeDiff = UDiffHelperUtils::GetVisibleNodes(Data.OriginalTreeDiff);
 
-	CallModelUpdated();
+	NotifyModelChanged(EDiffHelperModelChange::Sorting);
 }
 
 void UDiffHelperTabController::SetActiveWidgetIndex(const int32& InIndex) const
 {
 	Model->DiffPanelData.CurrentWidgetIndex = InIndex;
 
-	CallModelUpdated();
+	NotifyModelChanged(EDiffHelperModelChange::View);
 }
 
 void UDiffHelperTabController::SetSelectedCommits(const TArray<TSharedPtr<FDiffHelperCommit>>& InCommits) const
@@ -186,16 +276,304 @@ void UDiffHelperTabController::SelectNode(const TSharedPtr<FDiffHelperItemNode>&
 int32 UDiffHelperTabController::GetCommitIndex(const FDiffHelperCommit& InCommit) const
 {
 	const auto& Commits = Model->SelectedDiffItem.Commits;
-	return Commits.IndexOfByPredicate([&InCommit](const FDiffHelperCommit& Commit)
+
+	// Commits of an item come in history order, so the position is found by the history index
+	if (InCommit.HistoryIndex != INDEX_NONE)
+	{
+		const int32 Index = Algo::LowerBoundBy(Commits, InCommit.HistoryIndex, [](const TSharedPtr<FDiffHelperCommit>& Commit)
+		{
+			return Commit->HistoryIndex;
+		});
+
+		if (Commits.IsValidIndex(Index) && Commits[Index]->Revision == InCommit.Revision)
+		{
+			return Index;
+		}
+	}
+
+	return Commits.IndexOfByPredicate([&InCommit](const TSharedPtr<FDiffHelperCommit>& Commit)
+	{
+		return Commit->Revision == InCommit.Revision;
+	});
+}
+
+void UDiffHelperTabController::ResolveAssetData(FDiffHelperDiffItem& InOutItem) const
+{
+	if (!InOutItem.IsValid() || InOutItem.AssetData.IsValid())
+	{
+		return;
+	}
+
+	if (const auto* CachedAssetData = Model->AssetDataCache.Find(InOutItem.Path))
+	{
+		InOutItem.AssetData = *CachedAssetData;
+		return;
+	}
+
+	UDiffHelperUtils::ResolveAssetData(MakeArrayView(&InOutItem, 1));
+	Model->AssetDataCache.Add(InOutItem.Path, InOutItem.AssetData);
+}
+
+void UDiffHelperTabController::PrefetchDiffFiles(const FDiffHelperDiffItem& InDiffItem)
+{
+	CancelPrefetch();
+
+	if (!GetDefault<UDiffHelperSettings>()->bPrefetchDiffFiles || !CanDiffAgainstTarget())
+	{
+		return;
+	}
+
+	const auto CommitsToDiff = TArray<TSharedPtr<FDiffHelperCommit>>({InDiffItem.LastTargetCommit, InDiffItem.Commits[0]});
+	if (!UDiffHelperUtils::IsDiffAvailable(CommitsToDiff, InDiffItem.Path))
+	{
+		return;
+	}
+
+	const auto Manager = FDiffHelperModule::Get().GetManager();
+	if (!Manager.IsValid())
+	{
+		return;
+	}
+
+	PrefetchCancellationFlag = MakeShared<FThreadSafeBool>(false);
+
+	const IDiffHelperManager* ManagerPtr = Manager.Get();
+	const auto CancellationFlag = PrefetchCancellationFlag;
+	const auto Path = InDiffItem.Path;
+
+	// Files land in the blob cache, an extraction that is already running finishes even if the selection changes.
+	// Each task is counted before it's queued, so Deinit waits for it even if it hasn't started yet
+	for (const auto& Commit : CommitsToDiff)
+	{
+		if (!ManagerPtr->BeginBackgroundTask())
+		{
+			return;
+		}
+
+		Async(EAsyncExecution::ThreadPool, [ManagerPtr, CancellationFlag, Path, Revision = Commit->Revision]()
+		{
+			if (!*CancellationFlag)
+			{
+				ManagerPtr->GetFile(Path, Revision);
+			}
+
+			ManagerPtr->EndBackgroundTask();
+		});
+	}
+}
+
+void UDiffHelperTabController::CancelPrefetch()
+{
+	if (PrefetchCancellationFlag.IsValid())
+	{
+		PrefetchCancellationFlag->AtomicSet(true);
+		PrefetchCancellationFlag.Reset();
+	}
+}
+
+void UDiffHelperTabController::CancelCollectDiff()
+{
+	if (CollectDiffCancellationFlag.IsValid())
+	{
+		CollectDiffCancellationFlag->AtomicSet(true);
+		CollectDiffCancellationFlag.Reset();
+	}
+
+	if (Model)
 	{
-		return Commit.Revision == InCommit.Revision;
+		Model->DiffPanelData.bIsLoading = false;
+	}
+}
+
+void UDiffHelperTabController::SetLoadingStatus(const FText& InStatus)
+{
+	Model->DiffPanelData.LoadingStatus = InStatus;
+}
+
+void UDiffHelperTabController::AppendDiffItems(TArray<FDiffHelperDiffItem>&& InItems)
+{
+	SCOPED_NAMED_EVENT(UDiffHelperTabController_AppendDiffItems, FColor::Red);
+
+	// Batches are parsed independently, so equal commits from different batches are merged here
+	auto InternCommit = [this](TSharedPtr<FDiffHelperCommit>& InOutCommit)
+	{
+		if (!InOutCommit.IsValid())
+		{
+			return;
+		}
+
+		if (const auto* StoredCommit = Model->CommitStore.Find(InOutCommit->Revision))
+		{
+			InOutCommit = *StoredCommit;
+		}
+		else
+		{
+			Model->CommitStore.Add(InOutCommit->Revision, InOutCommit);
+		}
+	};
+
+	for (auto& Item : InItems)
+	{
+		InternCommit(Item.LastTargetCommit);
+		for (auto& Commit : Item.Commits)
+		{
+			InternCommit(Commit);
+		}
+	}
+
+	auto& Data = Model->DiffPanelData;
+	const auto NewNodes = UDiffHelperUtils::GenerateList(InItems);
+	Data.OriginalDiff.Append(NewNodes);
+	Model->Diff.Append(MoveTemp(InItems));
+
+	// Existing nodes keep their place and expansion, the order is fixed once in FinishCollectDiff
+	UDiffHelperUtils::InsertIntoTree(NewNodes, Data.OriginalTreeDiff, Data.NodesByPath);
+	FDiffHelperStats::Get().RecordTreeNodes(Data.NodesByPath.Num());
+
+	// Only the new nodes are tested, with the text a pending filter pass uses as well
+	const auto FilterText = Data.SearchFilter->GetRawFilterText().ToString();
+	TArray<TSharedPtr<FDiffHelperItemNode>> Passed;
+	UDiffHelperUtils::ApplyFilter(FilterText.IsEmpty() ? nullptr : Data.SearchFilter, NewNodes, Passed);
+	UDiffHelperUtils::AddVisibleLeaves(Passed);
+	Data.FilteredDiff.Append(Passed);
+
+	// FilteredDiff no longer matches the applied text alone, so the next query can't narrow it
+	if (Data.AppliedFilterText != FilterText)
+	{
+		Data.AppliedFilterText.Reset();
+	}
+
+	Data.TreeDiff = UDiffHelperUtils::GetVisibleNodes(Data.OriginalTreeDiff);
+
+	NotifyModelChanged(EDiffHelperModelChange::Filter);
+	Data.OnDiffItemsUpdated.Broadcast();
+}
+
+void UDiffHelperTabController::CancelFilterUpdate()
+{
+	FTSTicker::GetCoreTicker().RemoveTicker(SearchDebounceHandle);
+	SearchDebounceHandle.Reset();
+	FilterGeneration->Increment();
+}
+
+bool UDiffHelperTabController::DispatchFilterUpdate(float InDeltaTime)
+{
+	SCOPED_NAMED_EVENT(UDiffHelperTabController_DispatchFilterUpdate, FColor::Red);
+
+	SearchDebounceHandle.Reset();
+
+	auto& Data = Model->DiffPanelData;
+	Data.SearchFilter->SetRawFilterText(PendingSearchText);
+
+	const auto FilterText = PendingSearchText.ToString();
+	const auto bNarrowing = UDiffHelperUtils::IsNarrowingQuery(Data.AppliedFilterText, FilterText);
+
+	// Nodes and their diff items aren't modified while the worker reads them, visibility is written back on the game thread
+	TArray<TSharedPtr<FDiffHelperItemNode>> Candidates = bNarrowing ? Data.FilteredDiff : Data.OriginalDiff;
+	const int32 Generation = FilterGeneration->Increment();
+	const auto GenerationCounter = FilterGeneration;
+	const TWeakObjectPtr<UDiffHelperTabController> WeakThis = this;
+	const double DispatchTime = FPlatformTime::Seconds();
+
+	Async(EAsyncExecution::ThreadPool, [Candidates = MoveTemp(Candidates), FilterText, Generation, GenerationCounter, WeakThis, DispatchTime]() mutable
+	{
+		SCOPED_NAMED_EVENT(UDiffHelperTabController_FilterItems, FColor::Red);
+		DIFFHELPER_TRACE_SCOPE(DiffHelper_FilterItems);
+
+		// The model's filter is used by widgets for highlighting, so the worker gets its own
+		TTextFilter<const FDiffHelperDiffItem&> Filter(TTextFilter<const FDiffHelperDiffItem&>::FItemToStringArray::CreateStatic(&UDiffHelperTabController::PopulateFilterSearchString));
+		Filter.SetRawFilterText(FText::FromString(FilterText));
+
+		constexpr int32 CancellationCheckInterval = 1024;
+
+		TArray<TSharedPtr<FDiffHelperItemNode>> Passed;
+		Passed.Reserve(Candidates.Num());
+		for (int32 Index = 0; Index < Candidates.Num(); Index++)
+		{
+			if (Index % CancellationCheckInterval == 0 && GenerationCounter->GetValue() != Generation)
+			{
+				return;
+			}
+
+			const auto& Node = Candidates[Index];
+			if (FilterText.IsEmpty() || Filter.PassesFilter(*Node->DiffItem))
+			{
+				Passed.Add(Node);
+			}
+		}
+
+		AsyncTask(ENamedThreads::GameThread, [Candidates = MoveTemp(Candidates), Passed = MoveTemp(Passed), FilterText, Generation, GenerationCounter, WeakThis, DispatchTime]()
+		{
+			if (WeakThis.IsValid() && GenerationCounter->GetValue() == Generation)
+			{
+				WeakThis->ApplyFilterResult(Candidates, Passed, FilterText);
+
+				// Latency as seen by the user, from the end of the debounce until the lists are updated
+				FDiffHelperStats::Get().RecordFilter(FPlatformTime::Seconds() - DispatchTime, Candidates.Num());
+			}
+		});
 	});
+
+	return false;
+}
+
+void UDiffHelperTabController::ApplyFilterResult(const TArray<TSharedPtr<FDiffHelperItemNode>>& InCandidates, const TArray<TSharedPtr<FDiffHelperItemNode>>& InPassed, const FString& InFilterText)
+{
+	SCOPED_NAMED_EVENT(UDiffHelperTabController_ApplyFilterResult, FColor::Red);
+
+	for (const auto& Node : InCandidates)
+	{
+		Node->bVisible = false;
+	}
+
+	for (const auto& Node : InPassed)
+	{
+		Node->bVisible = true;
+	}
+
+	// Sort mode could change while the worker was running, so the order is taken from the sorted arrays
+	auto& Data = Model->DiffPanelData;
+	Data.FilteredDiff = UDiffHelperUtils::GetVisibleNodes(Data.OriginalDiff);
+	Data.AppliedFilterText = InFilterText;
+
+	UDiffHelperUtils::UpdateTreeVisibility(Data.OriginalTreeDiff);
+	Data.TreeDiff = UDiffHelperUtils::GetVisibleNodes(Data.OriginalTreeDiff);
+
+	NotifyModelChanged(EDiffHelperModelChange::Filter);
+	Data.OnDiffItemsUpdated.Broadcast();
+}
+
+void UDiffHelperTabController::FinishCollectDiff()
+{
+	CollectDiffCancellationFlag.Reset();
+
+	Model->Diff.Sort([](const FDiffHelperDiffItem& A, const FDiffHelperDiffItem& B)
+	{
+#if ENGINE_MAJOR_VERSION >= 5 && ENGINE_MINOR_VERSION >= 3
+		return UE::ComparisonUtility::CompareNaturalOrder(A.Path, B.Path) < 0;
+#else
+		return A.Path.Compare(B.Path, ESearchCase::IgnoreCase) < 0;
+#endif
+	});
+
+	// Batches were appended unsorted, visibility of directories is recounted in the same pass
+	auto& Data = Model->DiffPanelData;
+	UDiffHelperUtils::SortDiffList(Data.SortMode, Data.OriginalDiff);
+	UDiffHelperUtils::SortDiffTree(Data.SortMode, Data.OriginalTreeDiff);
+	Data.FilteredDiff = UDiffHelperUtils::GetVisibleNodes(Data.OriginalDiff);
+	UDiffHelperUtils::UpdateTreeVisibility(Data.OriginalTreeDiff);
+	Data.TreeDiff = UDiffHelperUtils::GetVisibleNodes(Data.OriginalTreeDiff);
+
+	Data.bIsLoading = false;
+	Data.LoadingStatus = FText::GetEmpty();
+
+	NotifyModelChanged(EDiffHelperModelChange::Diff);
+	Data.OnDiffItemsUpdated.Broadcast();
 }
 
 void UDiffHelperTabController::InitModel()
 {
 	Model = NewObject<UDiffHelperTabModel>(this);
-	Model->OnModelUpdated_Raw.AddWeakLambda(this, [this]() { Model->OnModelUpdated.Broadcast(); });
 }
 
 void UDiffHelperTabController::BindMenuCommands()
@@ -305,9 +683,9 @@ void UDiffHelperTabController::BindCommitPanelCommands()
 	);
 }
 
-FDiffHelperSimpleDelegate& UDiffHelperTabController::OnModelUpdated() const
+FDiffHelperModelChangedDelegate& UDiffHelperTabController::OnModelChanged() const
 {
-	return Model->OnModelUpdated_Raw;
+	return Model->OnModelChanged;
 }
 
 FDiffHelperSimpleDelegate& UDiffHelperTabController::OnPreWidgetIndexChanged() const
@@ -320,6 +698,11 @@ FDiffHelperSimpleDelegate& UDiffHelperTabController::OnTreeDiffExpansionUpdated(
 	return Model->DiffPanelData.OnTreeDiffExpansionUpdated;
 }
 
+FDiffHelperSimpleDelegate& UDiffHelperTabController::OnDiffItemsUpdated() const
+{
+	return Model->DiffPanelData.OnDiffItemsUpdated;
+}
+
 void UDiffHelperTabController::ToggleGroupByDirectory()
 {
 	OnPreWidgetIndexChanged().Broadcast();
@@ -327,18 +710,18 @@ void UDiffHelperTabController::ToggleGroupByDirectory()
 	auto& Data = Model->DiffPanelData;
 	Data.CurrentWidgetIndex = Data.CurrentWidgetIndex == SDiffHelperDiffPanelConstants::ListWidgetIndex ? SDiffHelperDiffPanelConstants::TreeWidgetIndex : SDiffHelperDiffPanelConstants::ListWidgetIndex;
 
-	CallModelUpdated();
+	NotifyModelChanged(EDiffHelperModelChange::View);
 }
 
 void UDiffHelperTabController::ExpandAll()
 {
-	UDiffHelperUtils::ExpandAll(Model->DiffPanelData.TreeDiff);
+	UDiffHelperUtils::ExpandAll(Model->DiffPanelData.OriginalTreeDiff);
 	OnTreeDiffExpansionUpdated().Broadcast();
 }
 
 void UDiffHelperTabController::CollapseAll()
 {
-	UDiffHelperUtils::CollapseAll(Model->DiffPanelData.TreeDiff);
+	UDiffHelperUtils::CollapseAll(Model->DiffPanelData.OriginalTreeDiff);
 	OnTreeDiffExpansionUpdated().Broadcast();
 }
 
@@ -420,7 +803,7 @@ void UDiffHelperTabController::ExecuteDiff(const TArray<TSharedPtr<FDiffHelperCo
 void UDiffHelperTabController::DiffAgainstTarget()
 {
 	const auto& DiffItem = Model->SelectedDiffItem;
-	const auto CommitsToDiff = TArray<TSharedPtr<FDiffHelperCommit>>({MakeShared<FDiffHelperCommit>(DiffItem.LastTargetCommit), MakeShared<FDiffHelperCommit>(DiffItem.Commits[0])});
+	const auto CommitsToDiff = TArray<TSharedPtr<FDiffHelperCommit>>({DiffItem.LastTargetCommit, DiffItem.Commits[0]});
 
 	ExecuteDiff(CommitsToDiff, DiffItem.Path);
 }
@@ -439,7 +822,7 @@ void UDiffHelperTabController::DiffSelectedCommitAgainstNext()
 	const auto& DiffItem = Model->SelectedDiffItem;
 
 	const auto Index = GetCommitIndex(*SelectedCommits[0]);
-	const auto CommitsToDiff = TArray<TSharedPtr<FDiffHelperCommit>>({SelectedCommits[0], MakeShared<FDiffHelperCommit>(DiffItem.Commits[Index - 1])});
+	const auto CommitsToDiff = TArray<TSharedPtr<FDiffHelperCommit>>({SelectedCommits[0], DiffItem.Commits[Index - 1]});
 
 	ExecuteDiff(CommitsToDiff, DiffItem.Path);
 }
@@ -450,7 +833,7 @@ void UDiffHelperTabController::DiffSelectedCommitAgainstPrevious()
 	const auto& DiffItem = Model->SelectedDiffItem;
 
 	const auto Index = GetCommitIndex(*SelectedCommits[0]);
-	const auto CommitsToDiff = TArray<TSharedPtr<FDiffHelperCommit>>({MakeShared<FDiffHelperCommit>(DiffItem.Commits[Index + 1]), SelectedCommits[0]});
+	const auto CommitsToDiff = TArray<TSharedPtr<FDiffHelperCommit>>({DiffItem.Commits[Index + 1], SelectedCommits[0]});
 
 	ExecuteDiff(CommitsToDiff, DiffItem.Path);
 }
@@ -460,7 +843,7 @@ void UDiffHelperTabController::DiffSelectedCommitAgainstNewest()
 	const auto& SelectedCommits = Model->CommitPanelData.SelectedCommits;
 	const auto& DiffItem = Model->SelectedDiffItem;
 
-	const auto CommitsToDiff = TArray<TSharedPtr<FDiffHelperCommit>>({SelectedCommits[0], MakeShared<FDiffHelperCommit>(DiffItem.Commits[0])});
+	const auto CommitsToDiff = TArray<TSharedPtr<FDiffHelperCommit>>({SelectedCommits[0], DiffItem.Commits[0]});
 
 	ExecuteDiff(CommitsToDiff, DiffItem.Path);
 }
@@ -470,7 +853,7 @@ void UDiffHelperTabController::DiffSelectedCommitAgainstOldest()
 	const auto& SelectedCommits = Model->CommitPanelData.SelectedCommits;
 	const auto& DiffItem = Model->SelectedDiffItem;
 
-	const auto CommitsToDiff = TArray<TSharedPtr<FDiffHelperCommit>>({MakeShared<FDiffHelperCommit>(DiffItem.Commits.Last()), SelectedCommits[0]});
+	const auto CommitsToDiff = TArray<TSharedPtr<FDiffHelperCommit>>({DiffItem.Commits.Last(), SelectedCommits[0]});
 
 	ExecuteDiff(CommitsToDiff, DiffItem.Path);
 }
@@ -480,7 +863,7 @@ bool UDiffHelperTabController::CanDiffAgainstTarget()
 	const auto& DiffItem = Model->SelectedDiffItem;
 	if (!DiffItem.IsValid()) { return false; }
 
-	const auto bLastTargetCommitValid = DiffItem.LastTargetCommit.IsValid();
+	const auto bLastTargetCommitValid = DiffItem.LastTargetCommit.IsValid() && DiffItem.LastTargetCommit->IsValid();
 	const auto bHasChanges = DiffItem.Commits.Num() > 0;
 	const auto bValidForDiff = UDiffHelperUtils::IsValidForDiff(DiffItem.Path);
 	return bLastTargetCommitValid && bHasChanges && bValidForDiff; 
@@ -521,29 +904,61 @@ bool UDiffHelperTabController::CanDiffSelectedCommitAgainstPrevious()
 
 	const auto Index = GetCommitIndex(*Data.SelectedCommits[0]);
 	const auto bValidForDiff = UDiffHelperUtils::IsValidForDiff(DiffItem.Path);
-	return Index < (Model->SelectedDiffItem.Commits.Num() - 1) && bValidForDiff;
+	return Index != INDEX_NONE && Index < (Model->SelectedDiffItem.Commits.Num() - 1) && bValidForDiff;
+}
+
+void UDiffHelperTabController::RebuildItemsData()
+{
+	SCOPED_NAMED_EVENT(UDiffHelperTabController_RebuildItemsData, FColor::Red);
+
+	auto& Data = Model->DiffPanelData;
+	UDiffHelperUtils::SortDiffList(Data.SortMode, Data.OriginalDiff);
+
+	const auto OldTreeDiff = Data.OriginalTreeDiff;
+	Data.OriginalTreeDiff = UDiffHelperUtils::ConvertListToTree(Data.OriginalDiff);
+	UDiffHelperUtils::CopyExpandedState(OldTreeDiff, Data.OriginalTreeDiff);
+	UDiffHelperUtils::SortDiffTree(Data.SortMode, Data.OriginalTreeDiff);
+
+	Data.NodesByPath.Reset();
+	UDiffHelperUtils::IndexTree(Data.OriginalTreeDiff, Data.NodesByPath);
+	FDiffHelperStats::Get().RecordTreeNodes(Data.NodesByPath.Num());
+
+	// New items have to be tested as well
+	Data.AppliedFilterText.Reset();
+	UpdateItemsData();
 }
 
 void UDiffHelperTabController::UpdateItemsData()
 {
-	// TODO: Estimate performance of this method.
+	SCOPED_NAMED_EVENT(UDiffHelperTabController_UpdateItemsData, FColor::Red);
+
+	// Filter pass running on a worker is based on the old items
+	FilterGeneration->Increment();
+
 	auto& Data = Model->DiffPanelData;
-	Data.FilteredDiff = Data.OriginalDiff;
-	
-	UDiffHelperUtils::FilterListItems(Data.SearchFilter, Data.FilteredDiff);
+	const auto FilterText = Data.SearchFilter.IsValid() ? Data.SearchFilter->GetRawFilterText().ToString() : FString();
+
+	// Items that didn't pass the previous query can't pass a narrower one, so only passed items are tested again.
+	// Both arrays are kept sorted, so the result doesn't need sorting either
+	if (UDiffHelperUtils::IsNarrowingQuery(Data.AppliedFilterText, FilterText))
+	{
+		const auto Candidates = MoveTemp(Data.FilteredDiff);
+		UDiffHelperUtils::ApplyFilter(Data.SearchFilter, Candidates, Data.FilteredDiff);
+	}
+	else
+	{
+		UDiffHelperUtils::ApplyFilter(FilterText.IsEmpty() ? nullptr : Data.SearchFilter, Data.OriginalDiff, Data.FilteredDiff);
+	}
 
-	const auto OldTreeDiff = Data.TreeDiff;
-	Data.TreeDiff = UDiffHelperUtils::ConvertListToTree(Data.FilteredDiff);
-	UDiffHelperUtils::CopyExpandedState(OldTreeDiff, Data.TreeDiff);
+	Data.AppliedFilterText = FilterText;
 
-	UDiffHelperUtils::SortDiffList(Data.SortMode, Data.FilteredDiff);
-	UDiffHelperUtils::SortDiffTree(Data.SortMode, Data.TreeDiff);
+	UDiffHelperUtils::UpdateTreeVisibility(Data.OriginalTreeDiff);
+	Data.TreeDiff = UDiffHelperUtils::GetVisibleNodes(Data.OriginalTreeDiff);
 
-	// TODO: We need to add more specific events for model update. Calling global update is not good approach.
-	CallModelUpdated();
+	NotifyModelChanged(EDiffHelperModelChange::Filter);
 }
 
-void UDiffHelperTabController::PopulateFilterSearchString(const FDiffHelperDiffItem& InItem, TArray<FString>& OutStrings) const
+void UDiffHelperTabController::PopulateFilterSearchString(const FDiffHelperDiffItem& InItem, TArray<FString>& OutStrings)
 {
 	OutStrings.Add(InItem.Path);
 }
@@ -106,8 +106,8 @@ TSharedRef<SWidget> SDiffHelperCommitItem::CreateDateColumn() const
 {
 	return
 		SNew(SDiffHelperCommitTextBlock)
-		.Text(FText::FromString(Item->Date.ToString()))
-		.ToolTip(FText::FromString(Item->Date.ToString()));
+		.Text(FText::AsDateTime(Item->Date))
+		.ToolTip(FText::AsDateTime(Item->Date, EDateTimeStyle::Full, EDateTimeStyle::Long));
 }
 
 END_SLATE_FUNCTION_BUILD_OPTIMIZATION
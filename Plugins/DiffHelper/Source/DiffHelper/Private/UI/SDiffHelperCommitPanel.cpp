@@ -22,15 +22,16 @@ void SDiffHelperCommitPanel::Construct(const FArguments& InArgs)
 
 	Controller = InArgs._Controller;
 
-	Controller->OnModelUpdated().AddRaw(this, &SDiffHelperCommitPanel::OnModelUpdated);
+	Controller->OnModelChanged().AddRaw(this, &SDiffHelperCommitPanel::OnModelChanged);
 
+	// Commits are shared with the model, so selection survives model updates
 	if (InArgs._Commits.Num() > 0)
 	{
-		Commits = UDiffHelperUtils::ConvertToShared(InArgs._Commits);
+		Commits = InArgs._Commits;
 	}
 	else
 	{
-		Commits = UDiffHelperUtils::ConvertToShared(Controller->GetModel()->SelectedDiffItem.Commits);
+		Commits = Controller->GetModel()->SelectedDiffItem.Commits;
 	}
 
 	FToolMenuContext MenuContext(Controller->GetCommitPanelCommands());
@@ -84,7 +85,7 @@ SDiffHelperCommitPanel::~SDiffHelperCommitPanel()
 {
 	if (Controller.IsValid() && IsValid(Controller->GetModel()))
 	{
-		Controller->OnModelUpdated().RemoveAll(this);
+		Controller->OnModelChanged().RemoveAll(this);
 	}
 }
 
@@ -103,18 +104,32 @@ TSharedRef<ITableRow> SDiffHelperCommitPanel::OnGenerateRow(TSharedPtr<FDiffHelp
 
 void SDiffHelperCommitPanel::OnSelectionChanged(TSharedPtr<FDiffHelperCommit> InCommit, ESelectInfo::Type InSelectInfo)
 {
+	// Oldest commit goes first, the list is ordered by history, so the stored index is enough to compare them
 	auto SelectedCommits = CommitList->GetSelectedItems();
-	SelectedCommits.Sort([&](const TSharedPtr<FDiffHelperCommit>& A, const TSharedPtr<FDiffHelperCommit>& B)
+	SelectedCommits.Sort([](const TSharedPtr<FDiffHelperCommit>& A, const TSharedPtr<FDiffHelperCommit>& B)
 	{
-		return Commits.IndexOfByKey(A) > Commits.IndexOfByKey(B);
+		return A->HistoryIndex > B->HistoryIndex;
 	});
 
 	Controller->SetSelectedCommits(SelectedCommits);
 }
 
-void SDiffHelperCommitPanel::OnModelUpdated()
+void SDiffHelperCommitPanel::OnModelChanged(EDiffHelperModelChange InChange)
 {
-	Commits = UDiffHelperUtils::ConvertToShared(Controller->GetModel()->SelectedDiffItem.Commits);
+	// Commits depend only on the selected item, filtering or sorting the diff doesn't affect them
+	if (!EnumHasAnyFlags(InChange, EDiffHelperModelChange::Selection | EDiffHelperModelChange::Diff))
+	{
+		return;
+	}
+
+	// Selecting another file with the same history keeps the list as is
+	const auto& SelectedCommits = Controller->GetModel()->SelectedDiffItem.Commits;
+	if (Commits == SelectedCommits)
+	{
+		return;
+	}
+
+	Commits = SelectedCommits;
 	CommitList->RequestListRefresh();
 }
 
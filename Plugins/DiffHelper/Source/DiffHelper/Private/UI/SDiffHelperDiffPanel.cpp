@@ -12,6 +12,7 @@
 #include "UI/SDiffHelperTreeItem.h"
 #include "UI/SDiffHelperDiffItemContextMenu.h"
 #include "Styling/ToolBarStyle.h"
+#include "Widgets/Images/SThrobber.h"
 #include "Widgets/Input/SSearchBox.h"
 #include "Widgets/Layout/SWidgetSwitcher.h"
 #include "Widgets/Views/STableViewBase.h"
@@ -88,21 +89,47 @@ void SDiffHelperDiffPanel::Construct(const FArguments& InArgs)
 		+ SVerticalBox::Slot()
 		.FillHeight(1.f)
 		[
-			SNew(SWidgetSwitcher)
-			.WidgetIndex(this, &SDiffHelperDiffPanel::GetWidgetIndex)
-			+ SWidgetSwitcher::Slot()
+			SNew(SOverlay)
+			+ SOverlay::Slot()
 			[
-				DiffList.ToSharedRef()
+				SNew(SWidgetSwitcher)
+				.WidgetIndex(this, &SDiffHelperDiffPanel::GetWidgetIndex)
+				+ SWidgetSwitcher::Slot()
+				[
+					DiffList.ToSharedRef()
+				]
+				+ SWidgetSwitcher::Slot()
+				[
+					DiffTree.ToSharedRef()
+				]
 			]
-			+ SWidgetSwitcher::Slot()
+			+ SOverlay::Slot()
+			.HAlign(HAlign_Center)
+			.VAlign(VAlign_Center)
 			[
-				DiffTree.ToSharedRef()
+				SNew(SVerticalBox)
+				.Visibility(this, &SDiffHelperDiffPanel::GetLoadingVisibility)
+				+ SVerticalBox::Slot()
+				.AutoHeight()
+				.HAlign(HAlign_Center)
+				[
+					SNew(SCircularThrobber)
+				]
+				+ SVerticalBox::Slot()
+				.AutoHeight()
+				.HAlign(HAlign_Center)
+				.Padding(0.f, 8.f, 0.f, 0.f)
+				[
+					SNew(STextBlock)
+					.Text(this, &SDiffHelperDiffPanel::GetLoadingStatus)
+				]
 			]
 		]
 	];
 
 	Controller->OnPreWidgetIndexChanged().AddRaw(this, &SDiffHelperDiffPanel::SyncSelection);
 	Controller->OnTreeDiffExpansionUpdated().AddSP(DiffTree.ToSharedRef(), &SDiffHelperDiffPanelTree::RequestTreeRefresh);
+	Controller->OnDiffItemsUpdated().AddSP(this, &SDiffHelperDiffPanel::OnDiffItemsUpdated);
 }
 
 EColumnSortMode::Type SDiffHelperDiffPanel::GetSortMode() const
@@ -115,6 +142,28 @@ int SDiffHelperDiffPanel::GetWidgetIndex() const
 	return Model.IsValid() ? Model->DiffPanelData.CurrentWidgetIndex : 0;
 }
 
+EVisibility SDiffHelperDiffPanel::GetLoadingVisibility() const
+{
+	// Items that are already loaded stay interactive under the throbber
+	return Model.IsValid() && Model->DiffPanelData.bIsLoading ? EVisibility::HitTestInvisible : EVisibility::Collapsed;
+}
+
+FText SDiffHelperDiffPanel::GetLoadingStatus() const
+{
+	return Model.IsValid() ? Model->DiffPanelData.LoadingStatus : FText::GetEmpty();
+}
+
+void SDiffHelperDiffPanel::OnDiffItemsUpdated()
+{
+	if (Model->DiffPanelData.SearchFilter.IsValid())
+	{
+		SearchBox->SetError(Model->DiffPanelData.SearchFilter->GetFilterErrorText());
+	}
+
+	DiffList->RequestListRefresh();
+	DiffTree->RequestTreeRefresh();
+}
+
 void SDiffHelperDiffPanel::SyncSelection()
 {
 	if (!Model->DiffPanelData.SelectedNode.IsValid())
@@ -129,8 +178,8 @@ void SDiffHelperDiffPanel::SyncSelection()
 		const auto& SelectedItems = DiffList->GetSelectedItems();
 		if (ensure(SelectedItems.Num() > 0))
 		{
-			const auto& TreeNode = UDiffHelperUtils::FindItemInTree(Model->DiffPanelData.TreeDiff, SelectedItems[0]);
-			if (TreeNode.IsValid())
+			const auto TreeNode = Model->DiffPanelData.NodesByPath.FindRef(SelectedItems[0]->Path);
+			if (TreeNode.IsValid() && TreeNode->bVisible)
 			{
 				DiffTree->SetSelection(TreeNode);
 				DiffTree->SetExpansionRecursiveReverse(TreeNode, true);
@@ -149,8 +198,9 @@ void SDiffHelperDiffPanel::SyncSelection()
 		const auto& SelectedItems = DiffTree->GetSelectedItems();
 		if (ensure(SelectedItems.Num() > 0))
 		{
-			const auto& ListItem = UDiffHelperUtils::FindItemInTree(Model->DiffPanelData.FilteredDiff, SelectedItems[0]);
-			if (ListItem.IsValid())
+			// Directories aren't shown in the list
+			const auto ListItem = Model->DiffPanelData.NodesByPath.FindRef(SelectedItems[0]->Path);
+			if (ListItem.IsValid() && ListItem->DiffItem.IsValid() && ListItem->bVisible)
 			{
 				DiffList->SetSelection(ListItem);
 			}
@@ -164,14 +214,7 @@ void SDiffHelperDiffPanel::SyncSelection()
 
 void SDiffHelperDiffPanel::OnSearchTextChanged(const FText& InText)
 {
-	Controller->SetSearchFilter(InText);
-	Controller->UpdateItemsData();
-
-	const auto Error = Model->DiffPanelData.SearchFilter->GetFilterErrorText();
-	SearchBox->SetError(Error);
-
-	DiffList->RequestListRefresh();
-	DiffTree->RequestTreeRefresh();
+	Controller->RequestFilterUpdate(InText);
 }
 
 void SDiffHelperDiffPanel::OnSortColumn(EColumnSortPriority::Type InPriority, const FName& InColumnId, EColumnSortMode::Type InSortMode)
@@ -211,7 +254,7 @@ void SDiffHelperDiffPanel::OnSelectionChanged(TSharedPtr<FDiffHelperItemNode> In
 		Controller->SelectNode(nullptr);
 	}
 
-	Controller->CallModelUpdated();
+	Controller->NotifyModelChanged(EDiffHelperModelChange::Selection);
 }
 
 TSharedRef<ITableRow> SDiffHelperDiffPanel::OnGenerateRow(TSharedPtr<FDiffHelperItemNode> InItem, const TSharedRef<STableViewBase>& InOwnerTable)
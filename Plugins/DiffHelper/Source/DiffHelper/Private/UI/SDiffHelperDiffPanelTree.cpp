@@ -57,18 +57,12 @@ void SDiffHelperDiffPanelTree::Tick(const FGeometry& AllottedGeometry, const dou
 	{
 		NeedRestoreExpansion = false;
 
-#if ENGINE_MAJOR_VERSION >= 5 && ENGINE_MINOR_VERSION >= 3
-		auto NewDirectories = UDiffHelperUtils::GetDirectories(GetRootItems());
-#elif ENGINE_MAJOR_VERSION == 5 && ENGINE_MINOR_VERSION == 2
-		auto NewDirectories = UDiffHelperUtils::GetDirectories(GetItems());
-#else
-		auto NewDirectories = UDiffHelperUtils::GetDirectories(*ItemsSource);
-#endif
-		
-		
-		for (const auto& NewDirectory : NewDirectories)
+		for (const auto& Node : Controller->GetModel()->DiffPanelData.NodesByPath)
 		{
-			SetItemExpansion(NewDirectory.Value, NewDirectory.Value->bExpanded);
+			if (!Node.Value->DiffItem.IsValid())
+			{
+				SetItemExpansion(Node.Value, Node.Value->bExpanded);
+			}
 		}
 	}
 }
@@ -76,37 +70,11 @@ void SDiffHelperDiffPanelTree::Tick(const FGeometry& AllottedGeometry, const dou
 void SDiffHelperDiffPanelTree::SetExpansionRecursiveReverse(TSharedPtr<FDiffHelperItemNode> InItem, bool bInExpand)
 {
 	SetItemExpansion(InItem, bInExpand);
-	// find all parents of InItem and expand them, using Directories map, where key - path to dir and value - dir node
-#if ENGINE_MAJOR_VERSION >= 5 && ENGINE_MINOR_VERSION >= 3
-	const auto& Directories = UDiffHelperUtils::GetDirectories(GetRootItems());
-#elif ENGINE_MAJOR_VERSION == 5 && ENGINE_MINOR_VERSION == 2
-	const auto& Directories = UDiffHelperUtils::GetDirectories(GetItems());
-#else
-	const auto& Directories = UDiffHelperUtils::GetDirectories(*ItemsSource);
-#endif
-
-	const auto& ItemPath = InItem->Path;
-	TArray<FString> PathComponents;
-	ItemPath.ParseIntoArray(PathComponents, TEXT("/"), true);
-
-	for (int32 Id = 0; Id < PathComponents.Num(); Id++)
-	{
-		// ParentPath work like this:
-		// 1 iteration => ParentPath == PathComponents[0]
-		// 2 iteration => ParentPath == PathComponents[0] + "/" + PathComponents[1]
-		// 3 iteration => ParentPath == PathComponents[0] + "/" + PathComponents[1] + "/" + PathComponents[2]
-		FString ParentPath = PathComponents[0];
-		for (int32 SubdirId = 1; SubdirId < Id; SubdirId++)
-		{
-			ParentPath = FPaths::Combine(ParentPath, PathComponents[SubdirId]);
-		}
 
-		if (Directories.Contains(ParentPath))
-		{
-			SetItemExpansion(Directories[ParentPath], bInExpand);
-		}
+	for (auto Parent = InItem->Parent.Pin(); Parent.IsValid(); Parent = Parent->Parent.Pin())
+	{
+		SetItemExpansion(Parent, bInExpand);
 	}
-	
 }
 
 void SDiffHelperDiffPanelTree::Private_SignalSelectionChanged(ESelectInfo::Type SelectInfo)
@@ -119,7 +87,14 @@ void SDiffHelperDiffPanelTree::Private_SignalSelectionChanged(ESelectInfo::Type
 
 void SDiffHelperDiffPanelTree::OnGetChildren(TSharedPtr<FDiffHelperItemNode> InItem, TArray<TSharedPtr<FDiffHelperItemNode>>& OutChildren)
 {
-	OutChildren = InItem->Children;
+	OutChildren.Reset(InItem->Children.Num());
+	for (const auto& Child : InItem->Children)
+	{
+		if (Child->bVisible)
+		{
+			OutChildren.Add(Child);
+		}
+	}
 }
 
 void SDiffHelperDiffPanelTree::SetExpansionRecursive(TSharedPtr<FDiffHelperItemNode> InItem, bool bInExpand)
@@ -91,8 +91,19 @@ void SDiffHelperTreeItem::ShowFileHint()
 
 void SDiffHelperTreeItem::ShowDirectoryHint()
 {
-	const auto& AllChildrenCount = UDiffHelperUtils::GetItemNodeFilesCount(Item);
-	Hint->SetText(FText::Format(LOCTEXT("TreeItemFilesCount", "{0} {0}|plural(one=file,other=files)"), AllChildrenCount));
+	// Rows outlive filtering, so the count is bound instead of being set once
+	Hint->SetText(TAttribute<FText>::CreateSP(this, &SDiffHelperTreeItem::GetDirectoryHint));
+}
+
+FText SDiffHelperTreeItem::GetDirectoryHint() const
+{
+	if (Item->VisibleFilesCount != CachedFilesCount)
+	{
+		CachedFilesCount = Item->VisibleFilesCount;
+		CachedDirectoryHint = FText::Format(LOCTEXT("TreeItemFilesCount", "{0} {0}|plural(one=file,other=files)"), CachedFilesCount);
+	}
+
+	return CachedDirectoryHint;
 }
 
 FSlateColor SDiffHelperTreeItem::GetTextColor() const
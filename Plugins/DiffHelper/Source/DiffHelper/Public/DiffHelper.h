@@ -45,6 +45,10 @@ private:
 	bool CanSpawnTab(const FSpawnTabArgs& Args) const;
 
 	void ToolbarButtonClicked();
+	void RefreshCommitGraphClicked();
+	bool CanRefreshCommitGraph() const;
+
+	bool InitializeManager();
 
 private:
 	TSharedPtr<class FUICommandList> PluginCommands;
@@ -0,0 +1,51 @@
+﻿// Copyright 2024 Gradess Games. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * Files extracted from git revisions for diffing, stored on disk by blob hash.
+ * Identical blobs from different revisions share one file. When the total size exceeds the byte budget,
+ * the least recently used files are removed. The index is rebuilt from the directory on construction,
+ * using file timestamps as the access order, so the budget is kept across editor sessions.
+ */
+class DIFFHELPER_API FDiffHelperBlobCache
+{
+public:
+	FDiffHelperBlobCache(const FString& InDirectory, const int64 InByteBudget);
+
+	// Returns the cached file and marks it as recently used
+	TOptional<FString> Find(const FString& InBlobHash, const FString& InExtension);
+
+	// Unique path for writing a new blob, pass it to Add once the file is complete
+	FString MakeTempPath() const;
+
+	// Moves a completely written file into the cache and evicts old entries if the budget is exceeded
+	TOptional<FString> Add(const FString& InBlobHash, const FString& InExtension, const FString& InTempPath);
+
+	void SetByteBudget(const int64 InByteBudget);
+	int64 GetUsedBytes() const;
+
+private:
+	struct FEntry
+	{
+		FString Path;
+		int64 Size = 0;
+		uint64 LastAccess = 0;
+	};
+
+	// Extension is a part of the key, since packages can't be loaded from files without a proper one
+	FString MakeKey(const FString& InBlobHash, const FString& InExtension) const;
+
+	void Scan();
+	void Evict(const FString& InKeepKey);
+
+	FString Directory;
+	int64 ByteBudget = 0;
+	int64 UsedBytes = 0;
+	uint64 AccessCounter = 0;
+
+	TMap<FString, FEntry> Entries;
+	mutable FCriticalSection CriticalSection;
+};
@@ -45,7 +45,15 @@ public:
 	UFUNCTION()
 	void Init();
 
+	// Diff cache is keyed by resolved commit hashes and doesn't use the object state, so it's safe to use from worker threads
+	static bool LoadDiff(const FString& InSourceHash, const FString& InTargetHash, TArray<FDiffHelperDiffItem>& OutDiff);
+	static void SaveDiff(const FString& InSourceHash, const FString& InTargetHash, const TArray<FDiffHelperDiffItem>& InDiff);
+	static FString GetDiffCacheDirectory();
+
 private:
 	void Cache();
 	FString GetConfigPath() const;
+
+	static FString GetDiffCachePath(const FString& InSourceHash, const FString& InTargetHash);
+	static void PruneDiffCache();
 };
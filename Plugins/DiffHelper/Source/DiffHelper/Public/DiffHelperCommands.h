@@ -20,6 +20,7 @@ public:
 public:
 	TSharedPtr<FUICommandInfo> OpenDiffWindow;
 	TSharedPtr<FUICommandInfo> CreateNewDiff;
+	TSharedPtr<FUICommandInfo> RefreshCommitGraph;
 
 	// Diff panel commands
 	TSharedPtr<FUICommandInfo> GroupByDirectory;
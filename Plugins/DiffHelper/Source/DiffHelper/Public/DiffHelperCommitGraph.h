@@ -0,0 +1,31 @@
+﻿// Copyright 2024 Gradess Games. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "DiffHelperTypes.h"
+
+/**
+ * Commits of a revision range together with the files they touched, built from a single "git log --raw" walk.
+ * Keeps a reverse index from path to commit indices, so history of a file is looked up without walking the commits again.
+ */
+class DIFFHELPER_API FDiffHelperCommitGraph
+{
+public:
+	FDiffHelperCommitGraph() = default;
+
+	// Commits are expected in log order, from newest to oldest. Their HistoryIndex is set to the position in it
+	explicit FDiffHelperCommitGraph(TArray<FDiffHelperCommit>&& InCommits);
+
+	const TArray<TSharedPtr<FDiffHelperCommit>>& GetCommits() const { return Commits; }
+	int32 GetPathCount() const { return PathIndex.Num(); }
+	void GetPaths(TArray<FString>& OutPaths) const;
+
+	// Indices into GetCommits() of the commits touching the path, from newest to oldest
+	const TArray<int32>* FindCommitIndices(const FString& InPath) const;
+	TArray<TSharedPtr<FDiffHelperCommit>> GetCommitsForPath(const FString& InPath) const;
+
+private:
+	TArray<TSharedPtr<FDiffHelperCommit>> Commits;
+	TMap<FString, TArray<int32>> PathIndex;
+};
@@ -0,0 +1,91 @@
+﻿// Copyright 2024 Gradess Games. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "HAL/ThreadSafeBool.h"
+
+class FDiffHelperGitProcess;
+
+enum class EDiffHelperCatFileMode : uint8
+{
+	// git cat-file --batch --filters, returns object contents
+	Batch,
+	// git cat-file --batch-check, returns object metadata only
+	BatchCheck
+};
+
+struct FDiffHelperGitObjectInfo
+{
+	FString Hash;
+	FString Type;
+	int64 Size = INDEX_NONE;
+
+	FORCEINLINE bool IsValid() const { return !Hash.IsEmpty(); }
+};
+
+/**
+ * Long-lived "git cat-file" process that answers object lookups over stdin / stdout,
+ * so each lookup costs a pipe round-trip instead of a process spawn.
+ * The process is restarted if it crashes, after several failed restarts in a row the worker is disabled
+ * and callers are expected to fall back to one-shot git commands.
+ */
+class DIFFHELPER_API FDiffHelperGitCatFileWorker
+{
+public:
+	FDiffHelperGitCatFileWorker(const FString& InGitBinaryPath, const FString& InRepositoryRoot, const EDiffHelperCatFileMode InMode);
+	~FDiffHelperGitCatFileWorker();
+
+	bool Start();
+	void Stop();
+
+	// False if the worker has been disabled after too many crashes
+	bool IsAvailable() const;
+
+	// Batch-check mode only. Object name can be anything git understands, e.g. "<rev>:<path>"
+	TOptional<FDiffHelperGitObjectInfo> GetObjectInfo(const FString& InObjectName);
+
+	// Batch mode only. Smudge filters (e.g. Git LFS) are applied based on InPath.
+	// Contents are written to the archive as they arrive, so a file writer never holds the whole object in memory
+	bool ReadObject(const FString& InObjectHash, const FString& InPath, FArchive& OutContent, FDiffHelperGitObjectInfo& OutInfo);
+
+	// Same as ReadObject, but fails right away if another thread is using the process
+	bool TryReadObject(const FString& InObjectHash, const FString& InPath, FArchive& OutContent, FDiffHelperGitObjectInfo& OutInfo);
+
+private:
+	enum class ERequestResult : uint8
+	{
+		Success,
+		Missing,
+		Failed
+	};
+
+	bool Request(const FString& InLine, FDiffHelperGitObjectInfo& OutInfo, FArchive* OutContent);
+	ERequestResult ExecuteRequest(const FString& InLine, FDiffHelperGitObjectInfo& OutInfo, FArchive* OutContent);
+
+	bool EnsureRunning();
+	bool Restart();
+
+	bool ReadLine(FString& OutLine);
+	bool ReadBytes(const int64 InCount, FArchive* OutData);
+	bool FillBuffer();
+	void ResetBuffer();
+
+private:
+	FString GitBinaryPath;
+	FString RepositoryRoot;
+	EDiffHelperCatFileMode Mode;
+
+	TUniquePtr<FDiffHelperGitProcess> Process;
+
+	TArray<uint8> Buffer;
+	int32 BufferOffset = 0;
+
+	// Restarts since the last successful request
+	int32 RestartCount = 0;
+
+	// Checked without the lock by IsAvailable
+	FThreadSafeBool bDisabled = false;
+
+	FCriticalSection CriticalSection;
+};
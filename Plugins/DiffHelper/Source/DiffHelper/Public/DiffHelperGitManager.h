@@ -5,10 +5,61 @@
 #include <CoreMinimal.h>
 #include <UObject/Object.h>
 #include "DiffHelperManager.h"
+#include "DiffHelperCommitGraph.h"
+#include "DiffHelperStats.h"
+#include "HAL/ThreadSafeCounter.h"
+#include "Async/Future.h"
 #include "DiffHelperTypes.h"
 #include "ISourceControlProvider.h"
 #include "DiffHelperGitManager.generated.h"
 
+class FDiffHelperBlobCache;
+class FDiffHelperGitCatFileWorker;
+struct FDiffHelperGitObjectInfo;
+
+struct FDiffHelperGitCommandResult
+{
+	bool bSuccess = false;
+	TArray<uint8> Output;
+	FString Errors;
+
+	// Wall time of the git process in seconds
+	double Duration = 0.0;
+};
+
+struct FDiffHelperCommitGraphStatus
+{
+	bool bExists = false;
+
+	// Changed-path Bloom filters let path-limited walks skip commits without diffing their trees
+	bool bHasChangedPaths = false;
+};
+
+struct FDiffHelperLastCommitsResult
+{
+	bool bSuccess = false;
+	TMap<FString, TSharedPtr<FDiffHelperCommit>> LastCommits;
+	FString Errors;
+
+	double Duration = 0.0;
+	int32 BatchCount = 0;
+};
+
+// Everything StreamDiff needs to build diff items, collected by UDiffHelperGitManager::QueryDiff
+struct FDiffHelperDiffQueryResult
+{
+	// Partial results aren't cached
+	bool bSuccess = false;
+
+	FDiffHelperCommitGraph CommitGraph;
+	TArray<FString> Files;
+	TMap<FString, EDiffHelperFileStatus> Statuses;
+	TMap<FString, TSharedPtr<FDiffHelperCommit>> LastCommits;
+
+	// Stage timings, the rest is filled by StreamDiff
+	FDiffHelperDiffStats Stats;
+};
+
 UCLASS()
 class DIFFHELPER_API UDiffHelperGitManager : public UObject, public IDiffHelperManager
 {
@@ -20,6 +71,31 @@ protected:
 
 	mutable FCriticalSection CriticalSection;
 
+	// Cached on the game thread, so git commands can be executed from worker threads
+	mutable TOptional<FString> RepositoryRoot;
+
+	// Used instead of the revision control settings when set, see SetRepositoryOverride
+	FString RepositoryRootOverride;
+	FString GitBinaryPathOverride;
+
+	mutable FThreadSafeCounter ActiveDiffCount;
+	FThreadSafeBool bShuttingDown = false;
+
+	// Persistent "git cat-file" processes, used to avoid spawning git for each object lookup
+	TSharedPtr<FDiffHelperGitCatFileWorker> BlobWorker;
+	TSharedPtr<FDiffHelperGitCatFileWorker> ObjectInfoWorker;
+
+	// Files extracted by GetFile, keyed by blob hash
+	TSharedPtr<FDiffHelperBlobCache> BlobCache;
+
+	// "objects/info" of the repository, where git keeps commit-graph files
+	FString ObjectsInfoDirectory;
+	FThreadSafeBool bRefreshingCommitGraph = false;
+
+	// Blobs being extracted right now, so concurrent requests for the same blob wait for a single extraction
+	mutable TMap<FString, TSharedFuture<TOptional<FString>>> PendingExtractions;
+	mutable FCriticalSection ExtractionsCriticalSection;
+
 public:
 #pragma region IDiffHelperManager
 	UFUNCTION()
@@ -44,29 +120,86 @@ public:
 	UFUNCTION()
 	virtual FDiffHelperCommit GetLastCommitForFile(const FString& InFilePath, const FString& InBranch) const override;
 
+	virtual void StreamDiff(const FString& InSourceRevision, const FString& InTargetRevision, const FDiffHelperDiffContext& InContext) const override;
 	virtual FSlateIcon GetStatusIcon(const EDiffHelperFileStatus InStatus) const override;
 	virtual TOptional<FString> GetFile(const FString& InFilename, const FString& InRevision) const override;
+	virtual bool BeginBackgroundTask() const override;
+	virtual void EndBackgroundTask() const override;
+
+	// Writes a commit-graph with changed-path Bloom filters
+	virtual void RefreshHistoryIndex() override;
+	virtual bool IsRefreshingHistoryIndex() const override { return bRefreshingCommitGraph; }
 #pragma endregion IDiffHelperManager
 
-	TMap<FString, FDiffHelperCommit> GetLastCommitForFiles(const TArray<FString>& InFilePaths, const FString& InBranch) const;
+	FDiffHelperCommitGraphStatus GetCommitGraphStatus() const;
+
+	// Points the manager to another repository, e.g. a generated one for benchmarks. Has to be called before Init
+	void SetRepositoryOverride(const FString& InRepositoryRoot, const FString& InGitBinaryPath);
+
+	TMap<FString, TSharedPtr<FDiffHelperCommit>> GetLastCommitForFiles(const TArray<FString>& InFilePaths, const FString& InBranch) const;
+	virtual TOptional<FDiffHelperGitObjectInfo> GetObjectInfo(const FString& InFilePath, const FString& InRevision) const;
+
+	// Full hash of the commit the revision points to
+	virtual TOptional<FString> ResolveRevision(const FString& InRevision) const;
+
+	// Regex-based parsing, used only in dev mode. FDiffHelperGitParser is used otherwise
+	TArray<FDiffHelperCommit> ParseCommits(const FString& InCommits) const;
+	FDateTime ParseDate(const FString& InDate) const;
+	TArray<FDiffHelperFileData> ParseChangedFiles(const FString& InFiles) const;
+
+	EDiffHelperFileStatus ConvertFileStatus(const FString& InStatus) const;
 
 protected:
 	UFUNCTION()
 	void LoadGitBinaryPath();
 
 	TOptional<FString> GetRepositoryDirectory() const;
+	TOptional<FString> FindRepositoryDirectory() const;
+
+	TOptional<FString> FindObjectsInfoDirectory() const;
+	// Time of a path-limited walk over the whole history, the kind of walk Bloom filters speed up
+	static double MeasurePathLimitedWalk(const FString& InGitBinaryPath, const FString& InRepositoryRoot);
+
+	virtual void StartWorkers();
+	void StopWorkers();
+	// Writes filtered contents of the blob to the archive, false if the blob has to be extracted by a one-shot git process
+	virtual bool ReadBlob(const FString& InBlobHash, const FString& InFilePath, FArchive& OutContent) const;
+	TOptional<FString> ExtractBlob(const FDiffHelperGitObjectInfo& InObjectInfo, const FString& InFilename, const FString& InRevision, const FString& InExtension) const;
 
 	bool ExecuteCommand(const FString& InCommand, const TArray<FString>& InParameters, const TArray<FString>& InFiles, FString& OutResults, FString& OutErrors) const;
+	bool ExecuteCommandRaw(const FString& InCommand, const TArray<FString>& InParameters, TArray<uint8>& OutResults, FString& OutErrors) const;
+
+	// Runs git on its own thread, so independent queries can overlap. The process is terminated once the cancellation flag is set
+	TFuture<FDiffHelperGitCommandResult> ExecuteCommandAsync(const FString& InCommand, const TArray<FString>& InParameters, const TSharedPtr<FThreadSafeBool>& InCancellationFlag = nullptr) const;
+	static FDiffHelperGitCommandResult RunCommand(const FString& InGitBinaryPath, const FString& InRepositoryRoot, const FString& InFullCommand, const TSharedPtr<FThreadSafeBool>& InCancellationFlag = nullptr);
+	static FString MakeFullCommand(const FString& InCommand, const TArray<FString>& InParameters);
+
+	// Runs "git log" with commit format and changed files, parser is picked based on dev mode
+	bool ExecuteLog(const TArray<FString>& InParameters, TArray<FDiffHelperCommit>& OutCommits, FString& OutErrors) const;
+
+	TArray<FString> MakeLogParameters(const TArray<FString>& InParameters) const;
+	TArray<FString> MakeDiffCommitsParameters(const FString& InSourceRevision, const FString& InTargetRevision) const;
+	// Single "git log --raw" walk over the range, parsed into FDiffHelperCommitGraph
+	TArray<FString> MakeCommitWalkParameters(const FString& InSourceRevision, const FString& InTargetRevision) const;
+	TArray<FString> MakeStatusParameters(const FString& InSourceRevision, const FString& InTargetRevision) const;
+
+	TArray<FDiffHelperCommit> ParseLogOutput(const TArray<uint8>& InOutput) const;
+	TMap<FString, EDiffHelperFileStatus> ParseStatusOutput(const TArray<uint8>& InOutput) const;
+	// Revision of the newest commit in InCommits touching each file
+	TMap<FString, FString> CollectLastRevisions(const TArray<FDiffHelperCommit>& InCommits) const;
+
+	// Commits of the range, statuses of the changed files and their last commits on the target. Returns false if cancelled
+	virtual bool QueryDiff(const FString& InSourceRevision, const FString& InTargetRevision, const FDiffHelperDiffContext& InContext, FDiffHelperDiffQueryResult& OutResult) const;
+
+	// Last commits of the paths on the branch, large path sets are split into parallel batches
+	virtual FDiffHelperLastCommitsResult QueryLastCommits(const TArray<FString>& InFilePaths, const FString& InBranch, const TSharedPtr<FThreadSafeBool>& InCancellationFlag = nullptr) const;
+	// Single "git log --stdin" process, the walk stops once every path has a commit
+	bool RunLastCommitsBatch(const TArray<FString>& InFilePaths, const FString& InBranch, const TSharedPtr<FThreadSafeBool>& InCancellationFlag, TArray<FDiffHelperCommit>& OutCommits, FString& OutErrors) const;
+
 	TOptional<FString> GetForkPoint(const FDiffHelperBranch& InSourceBranch, const FDiffHelperBranch& InTargetBranch) const;
 	TMap<FString, EDiffHelperFileStatus> GetStatuses(const FString& InSourceRevision, const FString& InTargetRevision) const;
 
 	TArray<FDiffHelperBranch> ParseBranches(const FString& InBranches) const;
-	TArray<FDiffHelperCommit> ParseCommits(const FString& InCommits) const;
-	FDiffHelperCommit ParseCommit(const FString& String) const;
-	FDateTime ParseDate(const FString& InDate) const;
-	TArray<FDiffHelperFileData> ParseChangedFiles(const FString& InFiles) const;
-
-	EDiffHelperFileStatus ConvertFileStatus(const FString& InStatus) const;
 
 	// Modified copy of GitSourceControlUtils::RunDumpToFile
 	bool ExtractFile(const FString& InParameter, const FString& InDumpFileName) const;
@@ -0,0 +1,39 @@
+﻿// Copyright 2024 Gradess Games. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Containers/StringView.h"
+#include "DiffHelperTypes.h"
+
+namespace DiffHelperGitFormat
+{
+	// Every commit starts with a record separator (0x1E), header fields are NUL-terminated.
+	// Must be used together with "-z", so changed files are NUL-delimited as well.
+	// Date is the committer date in Unix seconds, so it keeps seconds and doesn't depend on the local time format
+	inline constexpr const TCHAR* CommitFormat = TEXT("--pretty=format:\"%x1e%h%x00%s%x00%an%x00%ct%x00\"");
+	inline constexpr const TCHAR* NullTerminated = TEXT("-z");
+
+	constexpr uint8 RecordSeparator = 0x1E;
+}
+
+/**
+ * Single-pass tokenizer for NUL-delimited git output.
+ * Walks raw UTF-8 output once using string views and converts only the fields it keeps,
+ * so it doesn't depend on regex patterns from UDiffHelperSettings.
+ */
+class DIFFHELPER_API FDiffHelperGitParser
+{
+public:
+	// Output of "git log <DiffHelperGitFormat::CommitFormat> --name-status -z" or "--raw -z"
+	static TArray<FDiffHelperCommit> ParseCommits(const TArrayView<const uint8>& InOutput);
+
+	// Output of "git diff --name-status -z"
+	static TMap<FString, EDiffHelperFileStatus> ParseStatuses(const TArrayView<const uint8>& InOutput);
+
+	// Unix timestamp in seconds, the result is in UTC
+	static FDateTime ParseDate(const FUtf8StringView& InDate);
+
+	static EDiffHelperFileStatus ConvertFileStatus(const FUtf8StringView& InStatus);
+	static FString ToString(const FUtf8StringView& InView);
+};
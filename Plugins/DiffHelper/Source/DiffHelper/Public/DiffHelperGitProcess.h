@@ -0,0 +1,71 @@
+﻿// Copyright 2024 Gradess Games. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "HAL/ThreadSafeBool.h"
+
+/**
+ * Thin wrapper around a git child process with redirected stdin / stdout / stderr.
+ * Unlike FPlatformProcess::ExecProcess it keeps the process alive and exposes raw pipes,
+ * so it can be used both for long-lived workers and for binary outputs.
+ */
+class DIFFHELPER_API FDiffHelperGitProcess
+{
+public:
+	FDiffHelperGitProcess(const FString& InGitBinaryPath, const FString& InWorkingDirectory);
+	~FDiffHelperGitProcess();
+
+	FDiffHelperGitProcess(const FDiffHelperGitProcess&) = delete;
+	FDiffHelperGitProcess& operator=(const FDiffHelperGitProcess&) = delete;
+
+	bool Launch(const FString& InParameters, const bool bInRedirectInput = false);
+	// Once the flag is set, blocked writes and reads terminate the process and fail
+	void SetCancellationFlag(const TSharedPtr<FThreadSafeBool>& InCancellationFlag);
+	bool IsRunning();
+	void Terminate();
+
+	bool Write(const FString& InText);
+	bool Write(const uint8* InData, const int32 InSize);
+	void CloseInput();
+
+	// Appends available stdout data to OutData, returns number of appended bytes
+	int32 ReadOutput(TArray<uint8>& OutData);
+
+	// Waits until the next chunk of stdout is available, returns false once the process exited and its output is drained.
+	// Stderr is drained meanwhile, so the child can't block on a full error pipe
+	bool ReadOutputChunk(TArray<uint8>& OutChunk, FString& OutErrors);
+	void ReadErrors(FString& OutErrors);
+
+	// Reads the whole output until the process exits
+	bool RunToCompletion(TArray<uint8>& OutOutput, FString& OutErrors, int32& OutReturnCode);
+	int32 GetReturnCode();
+	int32 WaitForExit();
+
+	// Blocks until stdout or stderr has data, the child closes them or the timeout expires.
+	// Only Linux pipes are waitable, on other platforms it sleeps for a millisecond instead
+	void WaitForOutput(const float InTimeoutSeconds);
+
+private:
+	// Terminates the process if the cancellation flag is set
+	bool CheckCancelled();
+
+	// Blocks until stdin can take more data or the timeout expires, with the same platform limits as WaitForOutput
+	void WaitForInput(const float InTimeoutSeconds);
+
+	void ClosePipes();
+
+private:
+	FString GitBinaryPath;
+	FString WorkingDirectory;
+
+	FProcHandle ProcessHandle;
+	TSharedPtr<FThreadSafeBool> CancellationFlag;
+
+	void* StdOutRead = nullptr;
+	void* StdOutWrite = nullptr;
+	void* StdErrRead = nullptr;
+	void* StdErrWrite = nullptr;
+	void* StdInRead = nullptr;
+	void* StdInWrite = nullptr;
+};
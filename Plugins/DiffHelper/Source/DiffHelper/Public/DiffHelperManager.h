@@ -3,12 +3,27 @@
 #pragma once
 
 #include "CoreMinimal.h"
+#include "HAL/ThreadSafeBool.h"
 #include "UObject/Interface.h"
 #include "DiffHelperManager.generated.h"
 
 struct FDiffHelperBranch;
+struct FDiffHelperDiffItem;
 enum class EDiffHelperFileStatus : uint8;
 
+/** Callbacks and cancellation for a diff collected on a background thread. Callbacks are invoked on the calling thread */
+struct DIFFHELPER_API FDiffHelperDiffContext
+{
+	TSharedPtr<FThreadSafeBool> CancellationFlag;
+
+	TFunction<void(const FText& InStage)> OnStageChanged;
+	TFunction<void(TArray<FDiffHelperDiffItem>&& InItems)> OnBatchReady;
+
+	bool IsCancelled() const;
+	void ReportStage(const FText& InStage) const;
+	void ReportBatch(TArray<FDiffHelperDiffItem>&& InItems) const;
+};
+
 UINTERFACE(NotBlueprintable)
 class UDiffHelperManager : public UInterface
 {
@@ -41,6 +56,23 @@ public:
 	UFUNCTION(BlueprintCallable, Category = "DiffHelperManager")
 	virtual FDiffHelperCommit GetLastCommitForFile(const FString& InFilePath, const FString& InBranch) const = 0;
 
+	/**
+	 * Collects the same data as GetDiff, but reports it in batches through the context and can be cancelled.
+	 * Safe to call from a worker thread, AssetData of the items is not resolved, see UDiffHelperUtils::ResolveAssetData.
+	 */
+	virtual void StreamDiff(const FString& InSourceRevision, const FString& InTargetRevision, const FDiffHelperDiffContext& InContext) const = 0;
+
 	virtual FSlateIcon GetStatusIcon(const EDiffHelperFileStatus InStatus) const = 0;
 	virtual TOptional<FString> GetFile(const FString& InFilePath, const FString& InRevision) const = 0;
+
+	/**
+	 * Keeps Deinit waiting for a task that uses the manager from another thread, called before the task is dispatched.
+	 * Returns false if the manager is shutting down, otherwise the task has to call EndBackgroundTask once it's done.
+	 */
+	virtual bool BeginBackgroundTask() const = 0;
+	virtual void EndBackgroundTask() const = 0;
+
+	// Regenerates data that speeds up history walks (e.g. git commit-graph) in background
+	virtual void RefreshHistoryIndex() = 0;
+	virtual bool IsRefreshingHistoryIndex() const = 0;
 };
@@ -5,6 +5,7 @@
 #include <CoreMinimal.h>
 #include <UObject/Object.h>
 #include "DiffHelperTypes.h"
+#include "Internationalization/Regex.h"
 #include "DiffHelperSettings.generated.h"
 
 UCLASS(Config=DiffHelper)
@@ -91,12 +92,40 @@ public:
 	UPROPERTY(Config, EditAnywhere, Category = "Notification")
 	float ErrorExpireDuration = 2.f;
 
+	/** Keeps a long-lived "git cat-file" process to read files from revisions instead of spawning git for each file. Requires reopening Diff Helper */
+	UPROPERTY(Config, EditAnywhere, Category = "Performance")
+	bool bUsePersistentGitProcess = true;
+
+	/** Delay in seconds after the last keystroke before the diff search filter is applied */
+	UPROPERTY(Config, EditAnywhere, Category = "Performance", meta = (ClampMin = "0.0", UIMin = "0.0", UIMax = "1.0", Units = "s"))
+	float SearchDebounceInterval = 0.15f;
+
+	/** Stores collected diffs in Saved/DiffHelper, so reopening a diff between unchanged revisions doesn't run git queries again */
+	UPROPERTY(Config, EditAnywhere, Category = "Performance")
+	bool bEnableDiffCache = true;
+
+	/** Number of diffs kept in the cache, the least recently used ones are removed first */
+	UPROPERTY(Config, EditAnywhere, Category = "Performance", meta = (EditCondition = "bEnableDiffCache", ClampMin = "1"))
+	int32 MaxCachedDiffs = 16;
+
+	/** Disk budget in megabytes for files extracted from revisions for diffing, the least recently used ones are removed first */
+	UPROPERTY(Config, EditAnywhere, Category = "Performance", meta = (ClampMin = "16", Units = "MB"))
+	int32 BlobCacheSizeMB = 2048;
+
+	/** Writes a git commit-graph with changed-path Bloom filters in background when the repository doesn't have one. Speeds up history queries a lot on big repositories */
+	UPROPERTY(Config, EditAnywhere, Category = "Performance")
+	bool bWriteCommitGraph = false;
+
+	/** Extracts files for "Diff against target" in background as soon as a diff item is selected */
+	UPROPERTY(Config, EditAnywhere, Category = "Performance")
+	bool bPrefetchDiffFiles = true;
+
 	UPROPERTY(Config, EditAnywhere, Category = "Misc")
 	FString UnrealDocURL = TEXT("https://dev.epicgames.com/documentation/en-us/unreal-engine/collaboration-and-version-control-in-unreal-engine");
 
 #pragma region Git
-	// TODO: First - use parsing instead of regex, second - make it configurable 
-	/** Dev mode activates additional settings for Git parsing. DO NOT USE UNTIL YOU KNOW WHAT YOU'RE DOING. */
+	// TODO: make it configurable
+	/** Dev mode switches git log / diff parsing from FDiffHelperGitParser to the regex patterns below. DO NOT USE UNTIL YOU KNOW WHAT YOU'RE DOING. */
 	UPROPERTY()
 	bool bDevMode = false;
 	
@@ -114,13 +143,6 @@ public:
 	int32 DateGroup = 4;
 	int32 ChangedFilesGroup = 5;
 
-	FString DatePattern = TEXT("(\\d+)/(\\d+)/(\\d+) (\\d+):(\\d+)");
-	int32 DayGroup = 1;
-	int32 MonthGroup = 2;
-	int32 YearGroup = 3;
-	int32 HourGroup = 4;
-	int32 MinuteGroup = 5;
-
 	FString ChangedFilePattern = TEXT("(.).*\t(.*)(?:[\\s\n]|$)");
 	int32 ChangedFileStatusGroup = 1;
 	int32 ChangedFilePathGroup = 2;
@@ -129,9 +151,28 @@ public:
 public:
 	static bool IsCachingEnabled() { return GetDefault<UDiffHelperSettings>()->bEnableCaching; }
 
+	// Compiled pattern for one of the pattern members above, compiled once and safe to use from worker threads
+	FRegexPattern GetRegexPattern(const FString& InPattern) const;
+	void ResetRegexPatterns() const;
+
 #if WITH_EDITOR
 	virtual void PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent) override;
 #endif
 
-	
+private:
+	struct FCachedRegexPattern
+	{
+		FCachedRegexPattern(const FString& InSource)
+			: Source(InSource)
+			, Pattern(InSource)
+		{
+		}
+
+		FString Source;
+		FRegexPattern Pattern;
+	};
+
+	// Keyed by the pattern member, the source is kept to notice changes made outside of the editor, e.g. config reload
+	mutable TMap<const FString*, FCachedRegexPattern> RegexPatterns;
+	mutable FRWLock RegexPatternsLock;
 };
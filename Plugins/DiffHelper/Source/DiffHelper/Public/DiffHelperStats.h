@@ -0,0 +1,74 @@
+﻿// Copyright 2024 Gradess Games. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "HAL/ThreadSafeCounter64.h"
+#include "ProfilingDebugging/CpuProfilerTrace.h"
+#include "Trace/Trace.h"
+
+// Enable with "-trace=default,DiffHelper" or "Trace.Enable DiffHelper" to see git queries and parsing stages in Unreal Insights
+UE_TRACE_CHANNEL_EXTERN(DiffHelperChannel, DIFFHELPER_API);
+
+#define DIFFHELPER_TRACE_SCOPE(Name) TRACE_CPUPROFILER_EVENT_SCOPE_ON_CHANNEL(Name, DiffHelperChannel)
+
+// Timings of a single StreamDiff call, in seconds
+struct FDiffHelperDiffStats
+{
+	FString Range;
+	bool bFromCache = false;
+
+	double LogSeconds = 0.0;
+	double LogParseSeconds = 0.0;
+	double StatusSeconds = 0.0;
+	double StatusParseSeconds = 0.0;
+	double LastCommitsSeconds = 0.0;
+	double TotalSeconds = 0.0;
+
+	int32 FileCount = 0;
+	int32 CommitCount = 0;
+};
+
+/**
+ * Counters of git processes, cache lookups, tree sizes and filter latency, shared by all Diff Helper tabs.
+ * Values are mirrored to Unreal Insights counters, the last diffs are kept for "DiffHelper.Stats".
+ */
+class DIFFHELPER_API FDiffHelperStats
+{
+public:
+	static FDiffHelperStats& Get();
+
+	void RecordGitProcess();
+	void RecordBytesRead(const int64 InBytes);
+
+	void RecordDiffCache(const bool bInHit);
+	void RecordBlobCache(const bool bInHit);
+
+	void RecordDiff(const FDiffHelperDiffStats& InStats);
+	void RecordTreeNodes(const int32 InNodeCount);
+	void RecordFilter(const double InSeconds, const int32 InItemCount);
+
+	// Logs totals and the last InDiffCount diffs
+	void Dump(const int32 InDiffCount) const;
+
+private:
+	static constexpr int32 MaxRecordedDiffs = 32;
+
+	FThreadSafeCounter64 GitProcessCount;
+	FThreadSafeCounter64 BytesRead;
+	FThreadSafeCounter64 DiffCacheHits;
+	FThreadSafeCounter64 DiffCacheMisses;
+	FThreadSafeCounter64 BlobCacheHits;
+	FThreadSafeCounter64 BlobCacheMisses;
+
+	// Written on the game thread only
+	int32 TreeNodeCount = 0;
+	double LastFilterSeconds = 0.0;
+	double MaxFilterSeconds = 0.0;
+	int64 FilterCount = 0;
+
+	// Ring buffer, RecordedDiffCount is the total number of diffs recorded
+	TArray<FDiffHelperDiffStats> RecordedDiffs;
+	int32 RecordedDiffCount = 0;
+	mutable FCriticalSection DiffsCriticalSection;
+};
@@ -48,6 +48,26 @@ enum class EDiffHelperFileStatus : uint8
 	Unmerged
 };
 
+// Parts of UDiffHelperTabModel that changed, so widgets refresh only what depends on them
+enum class EDiffHelperModelChange : uint8
+{
+	None = 0,
+	// Selected diff item or node
+	Selection = 1 << 0,
+	// Search filter was applied, visibility of the items changed
+	Filter = 1 << 1,
+	Sorting = 1 << 2,
+	// Diff items were reloaded or collection has finished
+	Diff = 1 << 3,
+	// List / tree view switch
+	View = 1 << 4,
+
+	All = Selection | Filter | Sorting | Diff | View
+};
+ENUM_CLASS_FLAGS(EDiffHelperModelChange);
+
+DECLARE_MULTICAST_DELEGATE_OneParam(FDiffHelperModelChangedDelegate, EDiffHelperModelChange);
+
 USTRUCT(BlueprintType)
 struct FDiffHelperBranch
 {
@@ -98,6 +118,9 @@ struct FDiffHelperCommit
 	UPROPERTY(BlueprintReadOnly, Category = "Diff Helper")
 	TArray<FDiffHelperFileData> Files;
 
+	// Position in the history walk of the diff, newer commits have lower indices. INDEX_NONE for commits outside of the walk
+	int32 HistoryIndex = INDEX_NONE;
+
 	FORCEINLINE bool IsValid() const { return !Revision.IsEmpty(); }
 };
 
@@ -112,18 +135,22 @@ struct FDiffHelperDiffItem
 	UPROPERTY(BlueprintReadOnly, Category = "Diff Helper")
 	EDiffHelperFileStatus Status = EDiffHelperFileStatus::None;
 	
+	// Diff tab resolves it only for the selected item, see UDiffHelperTabController::SelectDiffItem
 	UPROPERTY(BlueprintReadOnly, Category = "Diff Helper")
 	FAssetData AssetData;
 
-	UPROPERTY(BlueprintReadOnly, Category = "Diff Helper")
-	FDiffHelperCommit LastTargetCommit;
-
-	UPROPERTY(BlueprintReadOnly, Category = "Diff Helper")
-	TArray<FDiffHelperCommit> Commits;
+	// Commits are shared between all items they touch, see UDiffHelperTabModel::CommitStore.
+	// Blueprints read them through UDiffHelperUtils::GetLastTargetCommit and GetCommits
+	TSharedPtr<FDiffHelperCommit> LastTargetCommit;
+	TArray<TSharedPtr<FDiffHelperCommit>> Commits;
 
 	FORCEINLINE bool IsValid() const { return !Path.IsEmpty(); }
 };
 
+// Binary serialization used by the diff cache. Asset data isn't serialized, it's resolved from the asset registry
+DIFFHELPER_API FArchive& operator<<(FArchive& Ar, FDiffHelperFileData& InFileData);
+DIFFHELPER_API FArchive& operator<<(FArchive& Ar, FDiffHelperCommit& InCommit);
+
 USTRUCT()
 struct FDiffHelperItemNode
 {
@@ -138,9 +165,19 @@ struct FDiffHelperItemNode
 	UPROPERTY()
 	bool bExpanded = false;
 
+	// Nodes that don't pass the search filter are hidden instead of being removed from the tree
+	UPROPERTY()
+	bool bVisible = true;
+
+	// Number of visible files under a directory node
+	int32 VisibleFilesCount = 0;
+
 	TSharedPtr<FDiffHelperDiffItem> DiffItem;
 	TArray<TSharedPtr<FDiffHelperItemNode>> Children;
 
+	// Directory node the node belongs to, unset for the roots and for nodes that aren't part of a tree
+	TWeakPtr<FDiffHelperItemNode> Parent;
+
 	FORCEINLINE bool IsValid() const { return !Path.IsEmpty(); }
 };
 
@@ -151,14 +188,28 @@ struct FDiffHelperDiffPanelData
 
 	FDiffHelperSimpleDelegate OnPreWidgetIndexChanged;
 	FDiffHelperSimpleDelegate OnTreeDiffExpansionUpdated;
+	FDiffHelperSimpleDelegate OnDiffItemsUpdated;
 
 	int32 CurrentWidgetIndex = 0;
+
+	// True while the diff is being collected in background, items arrive in batches meanwhile
+	bool bIsLoading = false;
+	FText LoadingStatus;
 	
 	TSharedPtr<TTextFilter<const FDiffHelperDiffItem&>> SearchFilter = nullptr;
 	
 	TArray<TSharedPtr<FDiffHelperItemNode>> OriginalDiff;
 	TArray<TSharedPtr<FDiffHelperItemNode>> FilteredDiff;
+
+	// Whole tree, its leaves are the nodes from OriginalDiff. TreeDiff contains only visible roots of it
+	TArray<TSharedPtr<FDiffHelperItemNode>> OriginalTreeDiff;
 	TArray<TSharedPtr<FDiffHelperItemNode>> TreeDiff;
+
+	// Every node of OriginalTreeDiff by path, files and directories. Files are the same nodes as in OriginalDiff
+	TMap<FString, TSharedPtr<FDiffHelperItemNode>> NodesByPath;
+
+	// Filter text the current visibility was computed for
+	FString AppliedFilterText;
 	TSharedPtr<FDiffHelperItemNode> SelectedNode;
 
 	EColumnSortMode::Type SortMode = EColumnSortMode::Ascending;
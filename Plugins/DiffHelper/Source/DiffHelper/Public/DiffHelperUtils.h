@@ -32,6 +32,20 @@ public:
 		return OutArray;
 	}
 
+	template<typename T>
+	static TArray<TSharedPtr<T>> ConvertToShared(TArray<T>&& InArray)
+	{
+		TArray<TSharedPtr<T>> OutArray;
+		OutArray.Reserve(InArray.Num());
+		for (auto& Item : InArray)
+		{
+			OutArray.Add(MakeShared<T>(MoveTemp(Item)));
+		}
+
+		InArray.Reset();
+		return OutArray;
+	}
+
 	template<typename T>
 	static FString EnumToString(const T EnumValue)
 	{
@@ -48,11 +62,23 @@ public:
 	UFUNCTION(BlueprintPure, Category = "DiffHelper|Utils")
 	static bool CompareStatus(const EDiffHelperFileStatus InStatusA, const EDiffHelperFileStatus InStatusB);
 
+	// Commits of diff items are shared and can't be exposed as properties, so Blueprints get copies of them
+	UFUNCTION(BlueprintPure, Category = "DiffHelper|Utils")
+	static FDiffHelperCommit GetLastTargetCommit(const FDiffHelperDiffItem& InItem);
+
+	UFUNCTION(BlueprintPure, Category = "DiffHelper|Utils")
+	static TArray<FDiffHelperCommit> GetCommits(const FDiffHelperDiffItem& InItem);
+
 public:
 	static bool IsDiffAvailable(const TSharedPtr<FDiffHelperCommit>& InCommit, const FString& InPath);
 	static bool IsDiffAvailable(const TArray<TSharedPtr<FDiffHelperCommit>>& InCommits, const FString& InPath);
 	static bool IsUnrealAsset(const FString& InPackageName);
 
+	// Package name of a file under the content directory, None for other files. Path is relative to the project directory
+	static FName GetAssetPackageName(const FString& InPath);
+	// Fills AssetData of all items with a single asset registry query, can be called from worker threads
+	static void ResolveAssetData(const TArrayView<FDiffHelperDiffItem>& InOutItems);
+
 	static int32 GetItemNodeFilesCount(const TSharedPtr<FDiffHelperItemNode>& InItem);
 	
 	static TArray<TSharedPtr<FDiffHelperItemNode>> GenerateList(const TArray<FDiffHelperDiffItem>& InItems);
@@ -60,15 +86,16 @@ public:
 	static TArray<TSharedPtr<FDiffHelperItemNode>> GenerateTree(const TArray<FDiffHelperDiffItem>& InItems);
 	static TArray<TSharedPtr<FDiffHelperItemNode>> GenerateTree(const TArray<TSharedPtr<FDiffHelperDiffItem>>& InItems);
 	static TSharedPtr<FDiffHelperItemNode> PopulateTree(const TArray<TSharedPtr<FDiffHelperDiffItem>>& InItems);
+	// Creates directory nodes only, leaves are shared with the list
+	static TSharedPtr<FDiffHelperItemNode> PopulateTree(const TArray<TSharedPtr<FDiffHelperItemNode>>& InLeaves);
 
 	static TArray<TSharedPtr<FDiffHelperItemNode>> ConvertTreeToList(const TArray<TSharedPtr<FDiffHelperItemNode>>& InRoot);
 	static TArray<TSharedPtr<FDiffHelperItemNode>> ConvertListToTree(const TArray<TSharedPtr<FDiffHelperItemNode>>& InList);
 
-	static TMap<FString, TSharedPtr<FDiffHelperItemNode>> GetDirectories(const TArray<TSharedPtr<FDiffHelperItemNode>>& InItems);
-	static TMap<FString, TSharedPtr<FDiffHelperItemNode>> GetDirectories(const TArrayView<const TSharedPtr<FDiffHelperItemNode>>& InItems);
-
-	static TSharedPtr<FDiffHelperItemNode> FindItemInTree(const TArray<TSharedPtr<FDiffHelperItemNode>>& InItems, const TSharedPtr<FDiffHelperItemNode>& InItem);
-	static TSharedPtr<FDiffHelperItemNode> FindItemInTree(const TArray<TSharedPtr<FDiffHelperItemNode>>& InItems, const FString& InPath);
+	// Adds every node of the tree to the map by path
+	static void IndexTree(const TArray<TSharedPtr<FDiffHelperItemNode>>& InNodes, TMap<FString, TSharedPtr<FDiffHelperItemNode>>& OutNodesByPath);
+	// Adds leaves to an existing indexed tree, missing directories are created hidden. Nodes are appended unsorted
+	static void InsertIntoTree(const TArray<TSharedPtr<FDiffHelperItemNode>>& InLeaves, TArray<TSharedPtr<FDiffHelperItemNode>>& InOutRoots, TMap<FString, TSharedPtr<FDiffHelperItemNode>>& InOutNodesByPath);
 
 	static void SortDiffList(const EColumnSortMode::Type InSortMode, TArray<TSharedPtr<FDiffHelperItemNode>>& OutArray);
 	static void SortDiffTree(const EColumnSortMode::Type InSortMode, TArray<TSharedPtr<FDiffHelperItemNode>>& OutArray);
@@ -78,6 +105,16 @@ public:
 	static void FilterTreeItems(const TSharedPtr<IFilter<const FDiffHelperDiffItem&>>& InFilter, TArray<TSharedPtr<FDiffHelperItemNode>>& OutArray);
 	static void Filter(TSharedPtr<IFilter<const FDiffHelperDiffItem&>> InFilter, TArray<TSharedPtr<FDiffHelperItemNode>>& OutArray);
 
+	// Tests only InCandidates and updates their visibility, passed nodes keep the order of InCandidates
+	static void ApplyFilter(const TSharedPtr<IFilter<const FDiffHelperDiffItem&>>& InFilter, const TArray<TSharedPtr<FDiffHelperItemNode>>& InCandidates, TArray<TSharedPtr<FDiffHelperItemNode>>& OutPassed);
+	// Propagates visibility of the leaves to directories, returns number of visible files
+	static int32 UpdateTreeVisibility(const TArray<TSharedPtr<FDiffHelperItemNode>>& InNodes);
+	// Counts leaves that became visible in their directories without walking the whole tree
+	static void AddVisibleLeaves(const TArray<TSharedPtr<FDiffHelperItemNode>>& InLeaves);
+	static TArray<TSharedPtr<FDiffHelperItemNode>> GetVisibleNodes(const TArray<TSharedPtr<FDiffHelperItemNode>>& InNodes);
+	// True if everything that passes InNewQuery is guaranteed to pass InPreviousQuery
+	static bool IsNarrowingQuery(const FString& InPreviousQuery, const FString& InNewQuery);
+
 	static void CopyExpandedState(const TArray<TSharedPtr<FDiffHelperItemNode>>& InSource, TArray<TSharedPtr<FDiffHelperItemNode>>& InTarget);
 	static void SetExpansionState(TArray<TSharedPtr<FDiffHelperItemNode>>& InArray, const bool bInExpanded);
 	static void ExpandAll(TArray<TSharedPtr<FDiffHelperItemNode>>& InArray);
@@ -89,5 +126,7 @@ public:
 	static FNotificationInfo GetBaseErrorNotificationInfo();
 
 	static void DiffFileExternal(const FString& InPath, const FDiffHelperCommit& InLeftRevision, const FDiffHelperCommit& InRightRevision);
+	// Extracts both revisions of the file in parallel
+	static bool GetDiffFiles(const FString& InPath, const FString& InLeftRevision, const FString& InRightRevision, FString& OutLeftFilename, FString& OutRightFilename);
 	static bool IsValidForDiff(const FString& InPath);
 };
@@ -4,6 +4,8 @@
 
 #include "CoreMinimal.h"
 #include "DiffHelperTypes.h"
+#include "Containers/Ticker.h"
+#include "HAL/ThreadSafeCounter.h"
 
 #include "UObject/Object.h"
 #include "DiffHelperTabController.generated.h"
@@ -27,6 +29,19 @@ protected:
 	TSharedPtr<FUICommandList> DiffPanelCommands;
 	TSharedPtr<FUICommandList> CommitPanelCommands;
 
+	// Set when diff collection running in background has to be dropped
+	TSharedPtr<FThreadSafeBool> CollectDiffCancellationFlag;
+
+	// Search text waiting for the debounce interval to pass
+	FText PendingSearchText;
+	FTSTicker::FDelegateHandle SearchDebounceHandle;
+
+	// Incremented for each filter pass, results of older passes are dropped
+	TSharedPtr<FThreadSafeCounter> FilterGeneration = MakeShared<FThreadSafeCounter>();
+
+	// Set when files prefetched for the previous selection aren't needed anymore
+	TSharedPtr<FThreadSafeBool> PrefetchCancellationFlag;
+
 public:	
 	UFUNCTION()
 	virtual void Init();
@@ -56,16 +71,24 @@ public:
 	UFUNCTION(BlueprintCallable, Category="Diff Helper")
 	void DiffAsset(const FString& InPath, const FDiffHelperCommit& InFirstRevision, const FDiffHelperCommit& InSecondRevision) const;
 
+	// Notifies about a change of the whole model, C++ code should use NotifyModelChanged with the exact change
 	UFUNCTION(BlueprintCallable, Category="Diff Helper")
 	void CallModelUpdated() const;
 
+	void NotifyModelChanged(EDiffHelperModelChange InChange) const;
+
 public:
 	// Unfortunately we can't return them as const TSharedPtr<FUICommandList>, because menu's arguments doesn't use const
 	TSharedPtr<FUICommandList> GetMenuCommands() const { return MenuCommands; }
 	TSharedPtr<FUICommandList> GetDiffPanelCommands() const { return DiffPanelCommands; }
 	TSharedPtr<FUICommandList> GetCommitPanelCommands() const { return CommitPanelCommands; }
 	
+	// Rebuilds the tree from OriginalDiff, used when the diff items change
+	void RebuildItemsData();
+	// Applies the search filter to the existing nodes
 	void UpdateItemsData();
+	// Filters items on a worker thread once the search text stops changing
+	void RequestFilterUpdate(const FText& InText);
 	
 	void SetSearchFilter(const FText& InText) const;
 	void SetSortingMode(const FName& InColumnId, EColumnSortMode::Type InSortMode) const;
@@ -74,14 +97,28 @@ public:
 	void SetSelectedCommits(const TArray<TSharedPtr<FDiffHelperCommit>>& InCommits) const;
 	void SelectNode(const TSharedPtr<FDiffHelperItemNode>& InNode) const;
 
-	FDiffHelperSimpleDelegate& OnModelUpdated() const;
+	FDiffHelperModelChangedDelegate& OnModelChanged() const;
 	FDiffHelperSimpleDelegate& OnPreWidgetIndexChanged() const;
 	FDiffHelperSimpleDelegate& OnTreeDiffExpansionUpdated() const;
+	FDiffHelperSimpleDelegate& OnDiffItemsUpdated() const;
 
 private:
 	int32 GetCommitIndex(const FDiffHelperCommit& InCommit) const;
+	void ResolveAssetData(FDiffHelperDiffItem& InOutItem) const;
 
 	void InitModel();
+
+	void CancelCollectDiff();
+	void SetLoadingStatus(const FText& InStatus);
+	void AppendDiffItems(TArray<FDiffHelperDiffItem>&& InItems);
+	void FinishCollectDiff();
+
+	void PrefetchDiffFiles(const FDiffHelperDiffItem& InDiffItem);
+	void CancelPrefetch();
+
+	void CancelFilterUpdate();
+	bool DispatchFilterUpdate(float InDeltaTime);
+	void ApplyFilterResult(const TArray<TSharedPtr<FDiffHelperItemNode>>& InCandidates, const TArray<TSharedPtr<FDiffHelperItemNode>>& InPassed, const FString& InFilterText);
 	
 	void BindMenuCommands();
 	void BindDiffPanelCommands();
@@ -112,5 +149,5 @@ private:
 	bool CanDiffSelectedCommitAgainstNext();
 	bool CanDiffSelectedCommitAgainstPrevious();
 	
-	void PopulateFilterSearchString(const FDiffHelperDiffItem& InItem, TArray<FString>& OutStrings) const;
+	static void PopulateFilterSearchString(const FDiffHelperDiffItem& InItem, TArray<FString>& OutStrings);
 };
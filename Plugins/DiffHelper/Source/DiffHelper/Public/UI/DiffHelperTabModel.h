@@ -16,7 +16,7 @@ class DIFFHELPER_API UDiffHelperTabModel : public UObject
 public:
 	UPROPERTY(BlueprintAssignable)
 	FDiffHelperSimpleDynamicDelegate OnModelUpdated;
-	FDiffHelperSimpleDelegate OnModelUpdated_Raw;
+	FDiffHelperModelChangedDelegate OnModelChanged;
 
 	UPROPERTY(BlueprintReadOnly, Category = "Diff Helper")
 	TArray<FDiffHelperDiffItem> Diff;
@@ -30,6 +30,12 @@ public:
 	UPROPERTY(BlueprintReadOnly, Category = "Diff Helper")
 	FDiffHelperDiffItem SelectedDiffItem;
 
+	// Every commit of the diff by revision, diff items and the commit panel reference these instances
+	TMap<FString, TSharedPtr<FDiffHelperCommit>> CommitStore;
+
+	// Asset data of the items selected so far by path, invalid for files that aren't assets
+	TMap<FString, FAssetData> AssetDataCache;
+
 	UPROPERTY()
 	FDiffHelperDiffPanelData DiffPanelData;
 	
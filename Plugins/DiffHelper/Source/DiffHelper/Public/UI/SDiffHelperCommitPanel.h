@@ -20,7 +20,7 @@ public:
 		}
 
 		SLATE_ARGUMENT(TWeakObjectPtr<UDiffHelperTabController>, Controller)
-		SLATE_ARGUMENT(TArray<FDiffHelperCommit>, Commits)
+		SLATE_ARGUMENT(TArray<TSharedPtr<FDiffHelperCommit>>, Commits)
 
 	SLATE_END_ARGS()
 
@@ -38,5 +38,5 @@ private:
 	TSharedRef<ITableRow> OnGenerateRow(TSharedPtr<FDiffHelperCommit> InItem, const TSharedRef<STableViewBase>& InOwnerTable);
 	TSharedPtr<SWidget> OnContextMenuOpening();
 	void OnSelectionChanged(TSharedPtr<FDiffHelperCommit> InCommit, ESelectInfo::Type InSelectInfo);
-	void OnModelUpdated();
+	void OnModelChanged(EDiffHelperModelChange InChange);
 };
@@ -40,6 +40,10 @@ public:
 protected:
 	EColumnSortMode::Type GetSortMode() const;
 	int GetWidgetIndex() const;
+	EVisibility GetLoadingVisibility() const;
+	FText GetLoadingStatus() const;
+
+	void OnDiffItemsUpdated();
 
 	void SyncSelection();
 
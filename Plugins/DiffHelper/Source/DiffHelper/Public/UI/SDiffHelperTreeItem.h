@@ -32,6 +32,9 @@ protected:
 	TSharedPtr<FDiffHelperItemNode> Item;
 
 	TWeakObjectPtr<UDiffHelperTabController> Controller;
+
+	mutable int32 CachedFilesCount = INDEX_NONE;
+	mutable FText CachedDirectoryHint;
 	
 public:
 	/** Constructs this widget with InArgs */
@@ -40,6 +43,7 @@ public:
 private:
 	void ShowFileHint();
 	void ShowDirectoryHint();
+	FText GetDirectoryHint() const;
 
 	FSlateColor GetTextColor() const;
 	FLinearColor GetTextHighlightColor() const;